@@ -104,6 +104,35 @@ enum MaaGlobalOptionEnum
     ///
     /// value: bool, eg: true; val_size: sizeof(bool)
     MaaGlobalOption_DebugMode = 6,
+
+    /// The level of log output to maa.log
+    ///
+    /// Statements below both this and the stdout level are skipped before anything is formatted.
+    /// Trace logs are only compiled into debug builds.
+    /// value: MaaLoggingLevel, val_size: sizeof(MaaLoggingLevel)
+    /// default value is MaaLoggingLevel_All
+    MaaGlobalOption_FileLevel = 7,
+
+    /// The format of the images written to the dumps dir when one is logged
+    ///
+    /// Images are written on a background thread, the log only names the file.
+    /// value: string, "png" or "jpg"; val_size: string length
+    /// default value is "png"
+    MaaGlobalOption_LogImageFormat = 8,
+
+    /// The maximum number of images written to the dumps dir per second
+    ///
+    /// Images logged beyond it are skipped, so that a burst of them does not pile up. 0 for no limit.
+    /// value: int, eg: 10; val_size: sizeof(int)
+    /// default value is 0
+    MaaGlobalOption_LogImageRateLimit = 9,
+
+    /// The compression of the images written to the dumps dir
+    ///
+    /// The zlib level of png, from 0 to 9, or the quality of jpg, from 0 to 100. -1 for the default of the format.
+    /// value: int, eg: 90; val_size: sizeof(int)
+    /// default value is -1, i.e. level 1 for png and quality 90 for jpg
+    MaaGlobalOption_LogImageQuality = 10,
 };
 
 typedef MaaOption MaaResOption;
@@ -196,6 +225,15 @@ enum MaaCtrlOptionEnum
     ///
     /// value: bool, eg: true; val_size: sizeof(bool)
     MaaCtrlOption_Recording = 5,
+
+    /// Capture continuously on a background thread, and let screencaps issued by tasks take the newest frame not older than
+    /// this bound (in milliseconds) instead of queueing behind actions. 0 disables it.
+    /// MaaControllerPostScreencap() is not affected.
+    /// Note that the screencap of the controller may then run concurrently with other actions.
+    ///
+    /// value: int, eg: 100; val_size: sizeof(int)
+    /// default value is 0
+    MaaCtrlOption_ScreencapStreaming = 6,
 };
 
 typedef MaaOption MaaTaskerOption;
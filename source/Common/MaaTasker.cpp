@@ -218,7 +218,7 @@ MaaBool MaaTaskerGetRecognitionDetail(
     CheckNullAndWarn(draws)
     {
         for (auto& d : result.draws) {
-            draws->append(MAA_NS::ImageBuffer(d));
+            draws->append(MAA_NS::ImageBuffer(d.clone()));
         }
     }
 
@@ -68,4 +68,23 @@ std::optional<std::string> UnitBase::startup_and_read_pipe(const ProcessArgv& ar
     return output;
 }
 
+bool UnitBase::startup_and_read_pipe(const ProcessArgv& argv, const IOStream::ChunkSink& sink, std::chrono::seconds timeout)
+{
+    auto start_time = std::chrono::steady_clock::now();
+
+    ChildPipeIOStream ios(argv.exec, argv.args);
+    size_t size = ios.read_chunks(sink, timeout);
+    bool ret = ios.release();
+
+    auto duration = duration_since(start_time);
+    LogDebug << VAR(size) << VAR(duration);
+
+    if (!ret) {
+        LogError << "child return error" << VAR(argv.exec) << VAR(argv.args);
+        return false;
+    }
+
+    return true;
+}
+
 MAA_CTRL_UNIT_NS_END
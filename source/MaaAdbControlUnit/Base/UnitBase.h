@@ -7,6 +7,7 @@
 #include "Base/ProcessArgvGenerator.h"
 #include "ControlUnit/AdbControlUnitAPI.h"
 #include "Screencap/ScreencapHelper.h"
+#include "Utils/IOStream/IOStream.h"
 
 MAA_CTRL_UNIT_NS_BEGIN
 
@@ -32,6 +33,11 @@ protected:
         /*out*/ ProcessArgvGenerator& argv);
 
     std::optional<std::string> startup_and_read_pipe(const ProcessArgv& argv, std::chrono::seconds timeout = std::chrono::seconds(20));
+    // hands the output to `sink` as it arrives
+    bool startup_and_read_pipe(
+        const ProcessArgv& argv,
+        const IOStream::ChunkSink& sink,
+        std::chrono::seconds timeout = std::chrono::seconds(20));
 
 protected:
     std::vector<std::shared_ptr<UnitBase>> children_;
@@ -63,6 +69,8 @@ public:
     virtual ~ScreencapBase() override = default;
 
     virtual bool init() = 0;
+    // stops what init() started, init() may be called again afterwards
+    virtual void deinit() {}
 
 public:
     virtual std::optional<cv::Mat> screencap() = 0;
@@ -45,6 +45,11 @@ bool LDPlayerExtras::init()
     return load_ld_library() && create_ld_instance();
 }
 
+void LDPlayerExtras::deinit()
+{
+    release_ld_instance();
+}
+
 std::optional<cv::Mat> LDPlayerExtras::screencap()
 {
     LogDebug;
@@ -101,6 +106,8 @@ bool LDPlayerExtras::create_ld_instance()
         return false;
     }
 
+    // init() again without deinit() must not leak the previous instance
+    release_ld_instance();
     ld_handle_ = create_instance_func_(ld_index_, ld_pid_);
 
     if (!ld_handle_) {
@@ -29,6 +29,7 @@ public: // from UnitBase
 
 public: // from ScreencapBase
     virtual bool init() override;
+    virtual void deinit() override;
 
     virtual std::optional<cv::Mat> screencap() override;
 
@@ -53,6 +53,11 @@ bool MuMuPlayerExtras::init()
     return load_mumu_library() && connect_mumu() && init_screencap();
 }
 
+void MuMuPlayerExtras::deinit()
+{
+    disconnect_mumu();
+}
+
 std::optional<cv::Mat> MuMuPlayerExtras::screencap()
 {
     LogDebug;
@@ -341,6 +346,8 @@ bool MuMuPlayerExtras::connect_mumu()
     std::u16string u16path = mumu_path_.u16string();
     std::wstring wpath(std::make_move_iterator(u16path.begin()), std::make_move_iterator(u16path.end()));
 
+    // init() again without deinit() must not leak the previous connection
+    disconnect_mumu();
     mumu_handle_ = connect_func_(wpath.c_str(), mumu_index_);
 
     if (mumu_handle_ == 0) {
@@ -382,6 +389,7 @@ void MuMuPlayerExtras::disconnect_mumu()
     if (mumu_handle_ != 0) {
         disconnect_func_(mumu_handle_);
     }
+    mumu_handle_ = 0;
 }
 
 void MuMuPlayerExtras::set_app_package(const std::string& package, int cloned_index)
@@ -24,6 +24,7 @@ public: // from UnitBase
 
 public: // from ScreencapBase
     virtual bool init() override;
+    virtual void deinit() override;
 
     virtual std::optional<cv::Mat> screencap() override;
 
@@ -1,5 +1,6 @@
 #include "ScreencapAgent.h"
 
+#include <algorithm>
 #include <format>
 #include <ranges>
 #include <unordered_set>
@@ -101,7 +102,18 @@ ScreencapAgent::ScreencapAgent(MaaAdbScreencapMethod methods, const std::filesys
         }
 
         children_.emplace_back(unit);
-        units_.emplace(method, unit);
+        auto entry = std::make_shared<Unit>();
+        entry->impl = std::move(unit);
+        units_.emplace(method, std::move(entry));
+    }
+}
+
+ScreencapAgent::~ScreencapAgent()
+{
+    quit_ = true;
+
+    if (retest_thread_.joinable()) {
+        retest_thread_.join();
     }
 }
 
@@ -110,7 +122,7 @@ bool ScreencapAgent::parse(const json::value& config)
     bool ret = false;
 
     for (auto it = units_.begin(); it != units_.end();) {
-        if (it->second->parse(config)) {
+        if (it->second->impl->parse(config)) {
             ret = true; // 任一成功就行
             ++it;
         }
@@ -127,13 +139,16 @@ bool ScreencapAgent::init()
 {
     LogFunc;
 
+    std::unique_lock lock(mutex_);
+
     if (active_unit_) {
         LogError << "already initialized" << VAR(active_unit_);
         return false;
     }
 
     for (auto it = units_.begin(); it != units_.end();) {
-        if (it->second->init()) {
+        if (it->second->impl->init()) {
+            it->second->inited = true;
             ++it;
         }
         else {
@@ -141,101 +156,337 @@ bool ScreencapAgent::init()
         }
     }
 
-    active_unit_ = speed_test();
-    if (!active_unit_) {
+    if (!speed_test()) {
         LogError << "No available screencap method";
         return false;
     }
 
-    units_.clear();
+    for (auto& [method, unit] : units_) {
+        if (method != active_method_) {
+            deinit(*unit);
+        }
+    }
+
     return true;
 }
 
 std::optional<cv::Mat> ScreencapAgent::screencap()
 {
+    // re-test at most once a minute when the active method degrades
+    constexpr auto kMinRetestInterval = std::chrono::minutes(1);
+
+    std::unique_lock lock(mutex_);
+
     if (!active_unit_) {
         LogError << "active_unit_ is null";
         return std::nullopt;
     }
 
-    return active_unit_->screencap();
+    if (retest_pending_ && !retesting_ && std::chrono::steady_clock::now() - last_test_time_ >= kMinRetestInterval) {
+        retest_pending_ = false;
+        start_retest();
+    }
+
+    do {
+        auto start_time = std::chrono::steady_clock::now();
+        auto image_opt = screencap_by(*active_unit_);
+        if (image_opt) {
+            on_success(duration_since(start_time));
+            return image_opt;
+        }
+    } while (fail_over());
+
+    return std::nullopt;
 }
 
 void ScreencapAgent::on_image_resolution_changed(const std::pair<int, int>& pre, const std::pair<int, int>& cur)
 {
-    if (!active_unit_) {
-        LogError << "active_unit_ is null";
-        return;
+    std::unique_lock lock(mutex_);
+
+    for (auto& unit : units_ | std::views::values) {
+        std::unique_lock unit_lock(unit->mutex);
+        unit->impl->on_image_resolution_changed(pre, cur);
     }
 
-    active_unit_->on_image_resolution_changed(pre, cur);
+    // the costs are not comparable anymore, re-test right away
+    retest_pending_ = true;
+    last_test_time_ = {};
 }
 
 void ScreencapAgent::on_app_started(const std::string& intent)
 {
-    if (!active_unit_) {
-        LogError << "active_unit_ is null";
-        return;
+    std::unique_lock lock(mutex_);
+
+    for (auto& unit : units_ | std::views::values) {
+        std::unique_lock unit_lock(unit->mutex);
+        unit->impl->on_app_started(intent);
     }
 
-    active_unit_->on_app_started(intent);
+    retest_pending_ = true;
 }
 
 void ScreencapAgent::on_app_stopped(const std::string& intent)
 {
-    if (!active_unit_) {
-        LogError << "active_unit_ is null";
-        return;
-    }
+    std::unique_lock lock(mutex_);
 
-    active_unit_->on_app_stopped(intent);
+    for (auto& unit : units_ | std::views::values) {
+        std::unique_lock unit_lock(unit->mutex);
+        unit->impl->on_app_stopped(intent);
+    }
 }
 
-std::shared_ptr<ScreencapBase> ScreencapAgent::speed_test()
+bool ScreencapAgent::speed_test()
 {
     LogFunc;
 
-    Method fastest = Method::UnknownYet;
-    std::chrono::milliseconds cost(INT64_MAX);
+    last_test_time_ = std::chrono::steady_clock::now();
+
+    std::vector<Cost> costs;
+    auto best = std::chrono::milliseconds::max();
+
+    for (auto& [method, unit] : units_) {
+        auto cost = measure(method, *unit->impl, best);
+        if (!cost) {
+            continue;
+        }
+        best = std::min(best, *cost);
+        costs.emplace_back(method, *cost);
+    }
+
+    if (costs.empty()) {
+        LogError << "cannot find any method to screencap!";
+        return false;
+    }
+
+    rank(std::move(costs));
+    active_method_ = ranking_.front();
+    active_unit_ = units_.at(active_method_);
+
+    LogInfo << "The fastest method is" << active_method_ << VAR(ranking_);
+    return true;
+}
+
+void ScreencapAgent::rank(std::vector<Cost> costs)
+{
+    std::ranges::sort(costs, {}, [](const auto& pair) { return pair.second; });
+
+    ranking_.clear();
+    stats_.clear();
+    for (const auto& [method, cost] : costs) {
+        ranking_.emplace_back(method);
+        stats_[method].tested_cost = cost;
+    }
+}
+
+void ScreencapAgent::start_retest()
+{
+    LogInfo << "re-test screencap methods" << VAR(active_method_);
+
+    // finished already, retesting_ is cleared as its last step
+    if (retest_thread_.joinable()) {
+        retest_thread_.join();
+    }
+
+    std::vector<std::pair<Method, std::shared_ptr<Unit>>> candidates;
+    for (const auto& [method, unit] : units_) {
+        if (method != active_method_) {
+            candidates.emplace_back(method, unit);
+        }
+    }
+
+    retesting_ = true;
+    last_test_time_ = std::chrono::steady_clock::now();
+    retest_thread_ = std::thread(&ScreencapAgent::retesting, this, active_method_, std::move(candidates));
+}
+
+void ScreencapAgent::retesting(Method tested_active, std::vector<std::pair<Method, std::shared_ptr<Unit>>> candidates)
+{
+    LogFunc << VAR(tested_active);
+
+    std::vector<Cost> costs;
+    auto best = std::chrono::milliseconds::max();
+    // the fastest candidate stays inited, so that it takes over without a pause
+    std::shared_ptr<Unit> best_unit;
 
-    auto check = [&fastest, &cost](Method method, std::chrono::steady_clock::time_point start) {
-        auto duration = duration_since(start);
-        if (duration < cost) {
-            fastest = method;
-            cost = duration;
+    for (auto& [method, unit] : candidates) {
+        if (quit_) {
+            break;
+        }
+
+        std::optional<std::chrono::milliseconds> cost;
+        {
+            std::unique_lock unit_lock(unit->mutex);
+            if (!unit->inited) {
+                unit->inited = unit->impl->init();
+            }
+            if (unit->inited) {
+                cost = measure(method, *unit->impl, best);
+            }
+            if (cost) {
+                costs.emplace_back(method, *cost);
+            }
+            if (!cost || *cost >= best) {
+                deinit(*unit);
+                continue;
+            }
         }
-        LogInfo << VAR(method) << VAR(duration);
-    };
+
+        if (best_unit) {
+            std::unique_lock unit_lock(best_unit->mutex);
+            deinit(*best_unit);
+        }
+        best = *cost;
+        best_unit = unit;
+    }
+
+    std::unique_lock lock(mutex_);
+    retesting_ = false;
+
+    if (quit_) {
+        return;
+    }
+
+    // the active method is measured by its recent screencaps rather than tested again
+    const auto& stats = stats_[active_method_];
+    auto active_cost =
+        stats.samples == 0 ? stats.tested_cost : std::chrono::milliseconds(static_cast<int64_t>(stats.average_cost));
+    std::erase_if(costs, [&](const Cost& cost) { return cost.first == active_method_; });
+    costs.emplace_back(active_method_, active_cost);
+
+    auto previous_method = active_method_;
+    auto previous_unit = active_unit_;
+    rank(std::move(costs));
+    for (Method method : units_ | std::views::keys) {
+        // failed to init or to screencap in the test, still worth a try before giving up
+        if (std::ranges::find(ranking_, method) == ranking_.end()) {
+            ranking_.emplace_back(method);
+        }
+    }
+    active_method_ = ranking_.front();
+    active_unit_ = units_.at(active_method_);
+
+    LogInfo << "The fastest method is" << active_method_ << VAR(previous_method) << VAR(ranking_);
+
+    for (const auto& unit : { previous_unit, best_unit }) {
+        if (unit && unit != active_unit_) {
+            std::unique_lock unit_lock(unit->mutex);
+            deinit(*unit);
+        }
+    }
+}
+
+std::optional<cv::Mat> ScreencapAgent::screencap_by(Unit& unit)
+{
+    std::unique_lock unit_lock(unit.mutex);
+
+    if (!unit.inited) {
+        unit.inited = unit.impl->init();
+        if (!unit.inited) {
+            LogError << "failed to init";
+            return std::nullopt;
+        }
+    }
+    return unit.impl->screencap();
+}
+
+std::optional<std::chrono::milliseconds> ScreencapAgent::measure(Method method, ScreencapBase& unit, std::chrono::milliseconds best)
+{
+    constexpr int kSamples = 3;
+    // a method whose first sample is this much slower than the best one is not sampled further
+    constexpr int kHopelessFactor = 3;
 
     // RawByNetcat 第一次速度很慢，但后面快
     // MinicapStream 是从缓存拉数据，只取一次不准
     static const std::unordered_set<Method> kDropFirst = { Method::RawByNetcat, Method::MinicapStream };
 
-    for (auto& [method, unit] : units_) {
-        if (kDropFirst.contains(method)) {
-            LogInfo << "Testing" << method << "drop first";
-            if (!unit->screencap()) {
-                LogWarn << "failed to test" << method;
-                continue;
-            }
+    if (kDropFirst.contains(method)) {
+        LogInfo << "Testing" << method << "drop first";
+        if (!unit.screencap()) {
+            LogWarn << "failed to test" << method;
+            return std::nullopt;
         }
+    }
 
-        LogInfo << "Testing" << method;
-        auto now = std::chrono::steady_clock::now();
-        if (!unit->screencap()) {
+    std::vector<std::chrono::milliseconds> samples;
+    for (int i = 0; i < kSamples; ++i) {
+        auto start_time = std::chrono::steady_clock::now();
+        if (!unit.screencap()) {
             LogWarn << "failed to test" << method;
-            continue;
+            return std::nullopt;
+        }
+        samples.emplace_back(duration_since(start_time));
+
+        if (samples.front() / kHopelessFactor > best) {
+            break;
         }
-        check(method, now);
     }
 
-    if (fastest == Method::UnknownYet) {
-        LogError << "cannot find any method to screencap!";
-        return nullptr;
+    // the median, a single sample is easily disturbed
+    std::ranges::nth_element(samples, samples.begin() + samples.size() / 2);
+    auto duration = samples.at(samples.size() / 2);
+    LogInfo << VAR(method) << VAR(duration) << VAR(samples.size());
+    return duration;
+}
+
+void ScreencapAgent::deinit(Unit& unit)
+{
+    if (!unit.inited) {
+        return;
+    }
+    unit.impl->deinit();
+    unit.inited = false;
+}
+
+void ScreencapAgent::on_success(std::chrono::milliseconds cost)
+{
+    // re-test when the moving average has been this much slower than the speed test for a while
+    constexpr double kDegradeFactor = 2.;
+    constexpr size_t kMinSamples = 10;
+    constexpr double kAlpha = 0.2;
+
+    auto& stats = stats_[active_method_];
+    stats.failures = 0;
+    stats.average_cost = stats.samples == 0 ? cost.count() : (1 - kAlpha) * stats.average_cost + kAlpha * cost.count();
+    ++stats.samples;
+
+    auto tested = std::max<int64_t>(stats.tested_cost.count(), 1);
+    if (!retest_pending_ && ranking_.size() > 1 && stats.samples >= kMinSamples && stats.average_cost > kDegradeFactor * tested) {
+        LogWarn << "screencap degraded" << VAR(active_method_) << VAR(stats.average_cost) << VAR(stats.tested_cost);
+        retest_pending_ = true;
     }
+}
 
-    LogInfo << "The fastest method is" << fastest << VAR(cost);
-    return units_[fastest];
+bool ScreencapAgent::fail_over()
+{
+    constexpr int kMaxFailures = 3;
+
+    auto& stats = stats_[active_method_];
+    ++stats.failures;
+    LogWarn << "screencap failed" << VAR(active_method_) << VAR(stats.failures);
+
+    if (stats.failures < kMaxFailures || ranking_.size() < 2) {
+        return false;
+    }
+    stats.failures = 0;
+
+    // the next one in the ranking, the failed one goes last
+    auto iter = std::ranges::find(ranking_, active_method_);
+    if (iter != ranking_.end()) {
+        std::rotate(iter, iter + 1, ranking_.end());
+    }
+    auto failed_unit = active_unit_;
+    active_method_ = ranking_.front();
+    active_unit_ = units_.at(active_method_);
+    retest_pending_ = true;
+
+    LogWarn << "fail over to" << active_method_ << VAR(ranking_);
+
+    // inited again from scratch if it is ever picked again
+    {
+        std::unique_lock unit_lock(failed_unit->mutex);
+        deinit(*failed_unit);
+    }
+    return true;
 }
 
 std::ostream& operator<<(std::ostream& os, ScreencapAgent::Method m)
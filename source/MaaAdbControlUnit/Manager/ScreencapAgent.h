@@ -1,6 +1,11 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
 #include <unordered_set>
+#include <vector>
 
 #include "Base/UnitBase.h"
 
@@ -24,7 +29,7 @@ public:
 
 public:
     ScreencapAgent(MaaAdbScreencapMethod methods, const std::filesystem::path& agent_path);
-    virtual ~ScreencapAgent() override = default;
+    virtual ~ScreencapAgent() override;
 
 public: // from UnitBase
     virtual bool parse(const json::value& config) override;
@@ -40,10 +45,55 @@ public: // from ControlUnitSink
     virtual void on_app_stopped(const std::string& intent) override;
 
 private:
-    std::shared_ptr<ScreencapBase> speed_test();
+    struct Unit
+    {
+        std::shared_ptr<ScreencapBase> impl;
+        bool inited = false;
+        // held while the unit is used, the re-test runs on a thread of its own
+        std::mutex mutex;
+    };
+
+    struct Stats
+    {
+        std::chrono::milliseconds tested_cost {}; // by the last speed test
+        double average_cost = 0;                  // exponential moving average in ms, since the last speed test
+        size_t samples = 0;
+        int failures = 0; // consecutive
+    };
+
+    using Cost = std::pair<Method, std::chrono::milliseconds>;
+
+    // ranks the methods and activates the fastest one
+    bool speed_test();
+    void rank(std::vector<Cost> costs);
+    void on_success(std::chrono::milliseconds cost);
+    bool fail_over(); // returns true if another method was activated
+
+    // tests the methods other than the active one off the screencap thread, and activates the fastest
+    void start_retest();
+    void retesting(Method tested_active, std::vector<std::pair<Method, std::shared_ptr<Unit>>> candidates);
+
+    static std::optional<cv::Mat> screencap_by(Unit& unit);
+    static std::optional<std::chrono::milliseconds>
+        measure(Method method, ScreencapBase& unit, std::chrono::milliseconds best = std::chrono::milliseconds::max());
+    static void deinit(Unit& unit); // with unit.mutex held, if another thread may use it
+
+    // every method that parsed is kept, but only the active one stays inited. the others are inited again when they are
+    // re-tested or failed over to, a MinicapStream nobody reads from would keep pulling frames otherwise.
+    std::unordered_map<Method, std::shared_ptr<Unit>> units_;
+    std::unordered_map<Method, Stats> stats_;
+    std::vector<Method> ranking_; // fastest first
+    Method active_method_ = Method::UnknownYet;
+    std::shared_ptr<Unit> active_unit_;
+
+    bool retest_pending_ = false;
+    bool retesting_ = false;
+    std::chrono::steady_clock::time_point last_test_time_;
+
+    std::mutex mutex_;
 
-    std::unordered_map<Method, std::shared_ptr<ScreencapBase>> units_;
-    std::shared_ptr<ScreencapBase> active_unit_;
+    std::atomic_bool quit_ = false;
+    std::thread retest_thread_;
 };
 
 std::ostream& operator<<(std::ostream& os, ScreencapAgent::Method m);
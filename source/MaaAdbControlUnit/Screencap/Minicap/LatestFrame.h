@@ -0,0 +1,114 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#include "Conf/Conf.h"
+#include "Utils/NoWarningCVMat.hpp"
+
+MAA_CTRL_UNIT_NS_BEGIN
+
+// Holds the newest frame of a stream. Consumers take it without any lock: a consumer pins the slot it copies from, and a
+// producer only writes to slots that are neither pinned nor published. Producers are serialized among themselves.
+class LatestFrame
+{
+public:
+    struct Frame
+    {
+        cv::Mat image; // empty when the stream broke
+        uint64_t seq = 0;
+        std::chrono::steady_clock::time_point time; // when it started to arrive
+    };
+
+public:
+    // frames older than the published one are dropped, so producers may finish out of order
+    void publish(cv::Mat image, uint64_t seq, std::chrono::steady_clock::time_point time)
+    {
+        std::unique_lock lock(publish_mutex_);
+
+        if (seq <= published_seq_) {
+            return;
+        }
+        published_seq_ = seq;
+
+        uint64_t tag = latest_.load();
+        size_t current = static_cast<size_t>(tag & kIndexMask);
+
+        while (true) {
+            for (size_t i = 0; i < kSlotCount; ++i) {
+                Slot& slot = slots_[i];
+                if ((tag != kEmptyTag && i == current) || slot.readers.load() != 0) {
+                    continue;
+                }
+
+                slot.frame = Frame { .image = std::move(image), .seq = seq, .time = time };
+                latest_.store((++version_ << kIndexBits) | i);
+                return;
+            }
+            // every free slot is being copied from, which only takes a moment
+            std::this_thread::yield();
+        }
+    }
+
+    // for a new stream, whose seqs start over. consumers may still be copying from the slots.
+    void reset()
+    {
+        std::unique_lock lock(publish_mutex_);
+
+        published_seq_ = 0;
+        // the version is kept, so a consumer that read the old tag never takes it for a new one
+        latest_.store(kEmptyTag);
+
+        for (Slot& slot : slots_) {
+            if (slot.readers.load() == 0) {
+                slot.frame = Frame {};
+            }
+        }
+    }
+
+    std::optional<Frame> load() const
+    {
+        while (true) {
+            uint64_t tag = latest_.load();
+            if (tag == kEmptyTag) {
+                return std::nullopt;
+            }
+
+            const Slot& slot = slots_[tag & kIndexMask];
+            slot.readers.fetch_add(1);
+            // the version in the tag changes on every publish, so an unchanged tag means the slot has not been rewritten
+            if (latest_.load() == tag) {
+                Frame frame = slot.frame;
+                slot.readers.fetch_sub(1);
+                return frame;
+            }
+            slot.readers.fetch_sub(1);
+        }
+    }
+
+private:
+    static constexpr size_t kSlotCount = 4;
+    static constexpr uint64_t kIndexBits = 2;
+    static constexpr uint64_t kIndexMask = (1 << kIndexBits) - 1;
+    static constexpr uint64_t kEmptyTag = 0;
+
+    struct Slot
+    {
+        Frame frame;
+        mutable std::atomic_size_t readers = 0;
+    };
+
+    std::array<Slot, kSlotCount> slots_;
+    std::atomic_uint64_t latest_ = kEmptyTag;
+
+    std::mutex publish_mutex_;
+    uint64_t version_ = 0;
+    uint64_t published_seq_ = 0;
+};
+
+MAA_CTRL_UNIT_NS_END
@@ -34,6 +34,9 @@ bool MinicapStream::init()
 {
     LogFunc;
 
+    // the threads of the previous connection read from the socket that is about to be replaced
+    release_thread();
+
     if (!init_binary()) {
         return false;
     }
@@ -47,41 +50,91 @@ bool MinicapStream::init()
     return true;
 }
 
+void MinicapStream::deinit()
+{
+    LogFunc;
+
+    // the binary stays on the device, a later init() only starts it again
+    release_thread();
+
+    sock_ios_ = nullptr;
+    pipe_ios_ = nullptr;
+}
+
 std::optional<cv::Mat> MinicapStream::screencap()
 {
     LogDebug;
 
-    std::unique_lock locker(mutex_);
+    const auto request_time = std::chrono::steady_clock::now();
 
-    using namespace std::chrono_literals;
-    cond_.wait_for(locker, 2s); // 等下一帧
+    // minicap only sends a frame when the screen changes. one that arrives after the request is preferred, since the
+    // screen may be changing because of the last input. if none comes shortly, the screen is taken as static.
+    auto frame = latest_frame_.load();
+    if (!frame || frame->time < request_time) {
+        std::unique_lock locker(new_frame_mutex_);
+
+        auto timeout = frame ? kNewFrameTimeout : kFirstFrameTimeout;
+        new_frame_cond_.wait_for(locker, timeout, [&]() {
+            frame = latest_frame_.load();
+            return frame && frame->time >= request_time;
+        });
+    }
 
-    return image_.empty() ? std::nullopt : std::make_optional(image_.clone());
+    if (!frame || frame->image.empty()) {
+        return std::nullopt;
+    }
+    // decoded frames are never written again, so they are shared rather than cloned
+    return frame->image;
 }
 
-std::optional<std::string> MinicapStream::read(size_t count)
+bool MinicapStream::read(char* buffer, size_t count)
 {
     if (!sock_ios_) {
         LogError << "sock_ios_ is nullptr";
-        return std::nullopt;
+        return false;
     }
 
     using namespace std::chrono_literals;
-    return sock_ios_->read_some(count, 1s);
+    size_t read_size = sock_ios_->read_into(buffer, count, 1s);
+    if (read_size != count) {
+        LogError << "read incomplete" << VAR(count) << VAR(read_size);
+        return false;
+    }
+    return true;
 }
 
 void MinicapStream::create_thread()
 {
+    // the seqs of the new stream start over
+    latest_frame_.reset();
+    encoded_frame_.reset();
+
     quit_ = false;
     pull_thread_ = std::thread(std::bind(&MinicapStream::pulling, this));
+    for (size_t i = 0; i < kDecodeThreads; ++i) {
+        decode_threads_.emplace_back(std::bind(&MinicapStream::decoding, this));
+    }
 }
 
 void MinicapStream::release_thread()
 {
-    quit_ = true;
+    {
+        std::unique_lock locker(decode_mutex_);
+        quit_ = true;
+        decode_cond_.notify_all();
+    }
+
     if (pull_thread_.joinable()) {
         pull_thread_.join();
     }
+    for (auto& thread : decode_threads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    decode_threads_.clear();
+
+    LogInfo << VAR(dropped_);
 }
 
 bool MinicapStream::connect_and_check()
@@ -133,12 +186,10 @@ bool MinicapStream::connect_and_check()
     // TODO: 解决大端底的情况
     MinicapHeader header;
 
-    auto data = read(sizeof(header));
-    if (!data) {
+    if (!read(reinterpret_cast<char*>(&header), sizeof(header))) {
         LogError << "read header failed";
         return false;
     }
-    header = *reinterpret_cast<const MinicapHeader*>(data->data());
 
     LogInfo << VAR(header.version) << VAR(header.size) << VAR(header.pid) << VAR(header.real_width) << VAR(header.real_height)
             << VAR(header.virt_width) << VAR(header.virt_height) << VAR(header.orientation) << VAR(header.flags);
@@ -147,7 +198,8 @@ bool MinicapStream::connect_and_check()
         return false;
     }
 
-    if (!read(header.size - sizeof(header))) {
+    std::string header_rest(header.size - sizeof(header), '\0');
+    if (!read(header_rest.data(), header_rest.size())) {
         LogError << "read header failed";
         return false;
     }
@@ -159,37 +211,101 @@ void MinicapStream::pulling()
 {
     LogFunc;
 
+    uint64_t seq = 0;
+
     while (!quit_) {
-        auto size_opt = read(4);
-        if (!size_opt) {
+        uint32_t size = 0;
+        if (!read(reinterpret_cast<char*>(&size), sizeof(size))) {
             LogError << "read size failed";
-            std::unique_lock locker(mutex_);
-            image_ = cv::Mat();
+            publish(cv::Mat(), ++seq, std::chrono::steady_clock::now());
             continue;
         }
-        auto size = *reinterpret_cast<const uint32_t*>(size_opt->data());
+        auto time = std::chrono::steady_clock::now();
 
-        auto data_opt = read(size);
-        if (!data_opt) {
+        std::string data = acquire_buffer();
+        data.resize(size);
+        if (!read(data.data(), size)) {
             LogError << "read data failed";
-            std::unique_lock locker(mutex_);
-            image_ = cv::Mat();
+            publish(cv::Mat(), ++seq, time);
             continue;
         }
 
-        auto img_opt = screencap_helper_.decode_jpg(*data_opt);
+        // decoded on other threads, so that a slow decode never holds up the socket
+        submit(EncodedFrame { .seq = ++seq, .time = time, .data = std::move(data) });
+    }
+}
+
+void MinicapStream::decoding()
+{
+    LogFunc;
+
+    while (true) {
+        EncodedFrame frame;
+        {
+            std::unique_lock locker(decode_mutex_);
+            decode_cond_.wait(locker, [&]() { return quit_ || encoded_frame_; });
+            if (quit_) {
+                return;
+            }
+
+            frame = std::move(*encoded_frame_);
+            encoded_frame_.reset();
+        }
+
+        auto img_opt = screencap_helper_.decode_jpg(frame.data);
+
+        {
+            std::unique_lock locker(decode_mutex_);
+            free_buffers_.emplace_back(std::move(frame.data));
+        }
 
         if (!img_opt || img_opt->empty()) {
             LogError << "decode jpg failed";
-            std::unique_lock locker(mutex_);
-            image_ = cv::Mat();
+            publish(cv::Mat(), frame.seq, frame.time);
             continue;
         }
 
-        std::unique_lock locker(mutex_);
-        image_ = std::move(*img_opt);
-        cond_.notify_all();
+        publish(std::move(*img_opt), frame.seq, frame.time);
+    }
+}
+
+std::string MinicapStream::acquire_buffer()
+{
+    std::unique_lock locker(decode_mutex_);
+
+    if (free_buffers_.empty()) {
+        return {};
+    }
+
+    // the capacity is kept, so no allocation happens once the buffers fit the largest frame
+    std::string buffer = std::move(free_buffers_.back());
+    free_buffers_.pop_back();
+    return buffer;
+}
+
+void MinicapStream::submit(EncodedFrame frame)
+{
+    std::unique_lock locker(decode_mutex_);
+
+    // the decoders are behind, the waiting frame is already outdated
+    if (encoded_frame_) {
+        ++dropped_;
+        free_buffers_.emplace_back(std::move(encoded_frame_->data));
+    }
+
+    encoded_frame_ = std::move(frame);
+    decode_cond_.notify_one();
+}
+
+void MinicapStream::publish(cv::Mat image, uint64_t seq, std::chrono::steady_clock::time_point time)
+{
+    latest_frame_.publish(std::move(image), seq, time);
+
+    {
+        // taking the lock makes sure a waiter either sees the frame or gets the notification
+        std::unique_lock locker(new_frame_mutex_);
     }
+    new_frame_cond_.notify_all();
 }
 
 MAA_CTRL_UNIT_NS_END
@@ -2,8 +2,13 @@
 
 #include "MinicapBase.h"
 
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <thread>
+#include <vector>
+
+#include "LatestFrame.h"
 
 #include "Utils/IOStream/ChildPipeIOStream.h"
 #include "Utils/IOStream/SockIOStream.h"
@@ -22,24 +27,53 @@ public: // from UnitBase
 
 public: // from ScreencapBase
     virtual bool init() override;
+    virtual void deinit() override;
     virtual std::optional<cv::Mat> screencap() override;
 
 private:
-    std::optional<std::string> read(size_t count);
+    struct EncodedFrame
+    {
+        uint64_t seq = 0;
+        std::chrono::steady_clock::time_point time;
+        std::string data;
+    };
+
+    bool read(char* buffer, size_t count);
     void create_thread();
     void release_thread();
     bool connect_and_check();
 
     void pulling();
+    void decoding();
+
+    std::string acquire_buffer();
+    void submit(EncodedFrame frame);
+    void publish(cv::Mat image, uint64_t seq, std::chrono::steady_clock::time_point time);
 
     ProcessArgvGenerator forward_argv_;
     int port_ = 0;
 
-    bool quit_ = true;
-    std::mutex mutex_;
-    cv::Mat image_;
-    std::condition_variable cond_;
+    static constexpr size_t kDecodeThreads = 2;
+    // how long a screencap waits for a frame that arrives after it was requested, the screen may not change at all
+    static constexpr std::chrono::milliseconds kNewFrameTimeout { 200 };
+    static constexpr std::chrono::milliseconds kFirstFrameTimeout { 2000 };
+
+    std::atomic_bool quit_ = true;
     std::thread pull_thread_;
+    std::vector<std::thread> decode_threads_;
+
+    // the frame read last and not picked up by a decoder yet, a newer one replaces it
+    std::optional<EncodedFrame> encoded_frame_;
+    // buffers of decoded frames, reused by the next reads
+    std::vector<std::string> free_buffers_;
+    size_t dropped_ = 0;
+    std::mutex decode_mutex_;
+    std::condition_variable decode_cond_;
+
+    LatestFrame latest_frame_;
+    // only used to wait for a new frame
+    std::mutex new_frame_mutex_;
+    std::condition_variable new_frame_cond_;
 
     std::shared_ptr<ChildPipeIOStream> pipe_ios_ = nullptr;
     std::shared_ptr<SockIOStream> sock_ios_ = nullptr;
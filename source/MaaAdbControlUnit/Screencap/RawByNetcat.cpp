@@ -43,16 +43,46 @@ bool ScreencapRawByNetcat::init()
 
 std::optional<cv::Mat> ScreencapRawByNetcat::screencap()
 {
-    if (!io_factory_) {
+    if (auto decoder = screencap_helper_.stream_decoder(false)) {
+        bool ret = capture([&](std::string_view chunk) { return decoder->feed(chunk); });
+
+        auto image_opt = decoder->finish();
+        if (image_opt) {
+            screencap_helper_.on_stream_succeeded();
+            return image_opt;
+        }
+        // nothing received is a transfer problem rather than a decoding one
+        if (!ret || decoder->received() == 0) {
+            return std::nullopt;
+        }
+        // the data is consumed, this capture is taken again without streaming
+        screencap_helper_.on_stream_failed();
+    }
+
+    std::string output;
+    bool ret = capture([&](std::string_view chunk) {
+        output.append(chunk);
+        return true;
+    });
+    if (!ret) {
         return std::nullopt;
     }
 
+    return screencap_helper_.process_data(output, ScreencapHelper::decode_raw);
+}
+
+bool ScreencapRawByNetcat::capture(const IOStream::ChunkSink& sink)
+{
+    if (!io_factory_) {
+        return false;
+    }
+
     auto port = io_factory_->port();
     merge_replacement({ { "{NETCAT_ADDRESS}", netcat_address_ }, { "{NETCAT_PORT}", std::to_string(port) } });
 
     auto argv_opt = screencap_raw_by_netcat_argv_.gen(argv_replace_);
     if (!argv_opt) {
-        return std::nullopt;
+        return false;
     }
     auto start_time = std::chrono::steady_clock::now();
 
@@ -63,23 +93,24 @@ std::optional<cv::Mat> ScreencapRawByNetcat::screencap()
     auto ios = io_factory_->accept();
     if (!ios) {
         LogError << "accept failed" << VAR(argv.exec) << VAR(argv.args);
-        return std::nullopt;
+        return false;
     }
 
     using namespace std::chrono_literals;
     // netcat 能用的时候一般都很快，但连不上的时候会一直卡着，所以超时设短一点
     ios->expires_after(1s);
-    std::string output = ios->read(1s);
+
+    size_t size = ios->read_chunks(sink, 1s);
     ios->release();
 
     auto duration = duration_since(start_time);
-    LogDebug << VAR(argv.exec) << VAR(argv.args) << VAR(output.size()) << VAR(duration);
+    LogDebug << VAR(argv.exec) << VAR(argv.args) << VAR(size) << VAR(duration);
 
     if (!child.release()) {
         LogWarn << "child return error" << VAR(argv.exec) << VAR(argv.args);
     }
 
-    return screencap_helper_.process_data(output, ScreencapHelper::decode_raw);
+    return true;
 }
 
 std::optional<std::string> ScreencapRawByNetcat::request_netcat_address()
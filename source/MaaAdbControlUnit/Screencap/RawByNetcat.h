@@ -21,6 +21,8 @@ public: // from ScreencapBase
     virtual std::optional<cv::Mat> screencap() override;
 
 private:
+    // runs the screencap command and hands what netcat sends to `sink`
+    bool capture(const IOStream::ChunkSink& sink);
     std::optional<std::string> request_netcat_address();
 
     ProcessArgvGenerator screencap_raw_by_netcat_argv_;
@@ -0,0 +1,247 @@
+#include "RawStreamDecoder.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <zlib.h>
+
+#include "Utils/Logger.h"
+#include "Utils/NoWarningCV.hpp"
+
+MAA_CTRL_UNIT_NS_BEGIN
+
+RawStreamDecoder::RawStreamDecoder(bool gzip, bool clean_cr)
+    : clean_cr_(clean_cr)
+{
+    if (!gzip) {
+        return;
+    }
+
+    zs_ = std::make_unique<z_stream_s>();
+    // 16: expect a gzip header instead of a zlib one
+    if (inflateInit2(zs_.get(), 16 + MAX_WBITS) != Z_OK) {
+        LogError << "inflateInit2 failed";
+        zs_ = nullptr;
+        failed_ = true;
+    }
+}
+
+RawStreamDecoder::~RawStreamDecoder()
+{
+    if (zs_) {
+        inflateEnd(zs_.get());
+    }
+}
+
+bool RawStreamDecoder::feed(std::string_view data)
+{
+    received_ += data.size();
+
+    if (failed_) {
+        return false;
+    }
+
+    if (!clean_cr_) {
+        return feed_cleaned(data);
+    }
+
+    // the same as ScreencapHelper::clean_cr, but a `\r` at the end of a chunk has to wait for the next one
+    cleaned_.clear();
+    if (pending_cr_ && !data.empty()) {
+        pending_cr_ = false;
+        if (data.front() != '\n') {
+            cleaned_.push_back('\r');
+        }
+    }
+
+    size_t pos = 0;
+    while (pos < data.size()) {
+        size_t cr = data.find('\r', pos);
+        if (cr == std::string_view::npos) {
+            cleaned_.append(data.substr(pos));
+            break;
+        }
+
+        cleaned_.append(data.substr(pos, cr - pos));
+        if (cr + 1 == data.size()) {
+            pending_cr_ = true;
+            break;
+        }
+        if (data[cr + 1] != '\n') {
+            cleaned_.push_back('\r');
+        }
+        pos = cr + 1;
+    }
+
+    return feed_cleaned(cleaned_);
+}
+
+std::optional<cv::Mat> RawStreamDecoder::finish()
+{
+    if (pending_cr_) {
+        pending_cr_ = false;
+        feed_cleaned("\r");
+    }
+
+    if (failed_) {
+        return std::nullopt;
+    }
+    if (zs_ && !inflate_end_) {
+        LogError << "incomplete gzip data";
+        return std::nullopt;
+    }
+    if (image_.empty() || next_row_ != height_ || !row_.empty()) {
+        LogError << "incomplete image" << VAR(width_) << VAR(height_) << VAR(next_row_) << VAR(row_.size());
+        return std::nullopt;
+    }
+    if (!alpha_ok_) { // only check alpha, the same as ScreencapHelper::decode_raw
+        LogError << "the last pixel is not opaque";
+        return std::nullopt;
+    }
+
+    return image_;
+}
+
+bool RawStreamDecoder::feed_cleaned(std::string_view data)
+{
+    if (!zs_) {
+        return feed_inflated(data);
+    }
+
+    if (inflate_end_) {
+        // trailing bytes after the gzip member are ignored, as gzip::decompress does
+        return true;
+    }
+
+    constexpr size_t kInflateBufferSize = 256 * 1024;
+    inflated_.resize(kInflateBufferSize);
+
+    zs_->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    zs_->avail_in = static_cast<uInt>(data.size());
+
+    do {
+        zs_->next_out = reinterpret_cast<Bytef*>(inflated_.data());
+        zs_->avail_out = static_cast<uInt>(inflated_.size());
+
+        int ret = inflate(zs_.get(), Z_NO_FLUSH);
+        if (ret != Z_OK && ret != Z_STREAM_END && ret != Z_BUF_ERROR) {
+            LogError << "inflate failed" << VAR(ret);
+            failed_ = true;
+            return false;
+        }
+
+        size_t produced = inflated_.size() - zs_->avail_out;
+        if (produced != 0 && !feed_inflated(std::string_view(inflated_.data(), produced))) {
+            return false;
+        }
+
+        if (ret == Z_STREAM_END) {
+            inflate_end_ = true;
+            break;
+        }
+        if (ret == Z_BUF_ERROR) {
+            // no progress is possible until more data arrives
+            break;
+        }
+    } while (zs_->avail_in != 0 || zs_->avail_out == 0);
+
+    return true;
+}
+
+bool RawStreamDecoder::feed_inflated(std::string_view data)
+{
+    if (!feed_header(data)) {
+        return false;
+    }
+    if (data.empty()) {
+        return true;
+    }
+    return feed_pixels(data);
+}
+
+bool RawStreamDecoder::feed_header(std::string_view& data)
+{
+    constexpr size_t kMaxHeaderSize = 16;
+    constexpr uint32_t kMaxSide = 16384;
+
+    if (!image_.empty()) {
+        return true;
+    }
+
+    size_t count = std::min(kMaxHeaderSize - header_.size(), data.size());
+    header_.append(data.substr(0, count));
+    data.remove_prefix(count);
+    if (header_.size() < kMaxHeaderSize) {
+        return true;
+    }
+
+    uint32_t width = 0, height = 0;
+    memcpy(&width, header_.data(), 4);
+    memcpy(&height, header_.data() + 4, 4);
+    if (width == 0 || height == 0 || width > kMaxSide || height > kMaxSide) {
+        LogError << "invalid image size" << VAR(width) << VAR(height);
+        failed_ = true;
+        return false;
+    }
+
+    width_ = static_cast<int>(width);
+    height_ = static_cast<int>(height);
+    image_.create(height_, width_, CV_8UC3);
+    row_.reserve(static_cast<size_t>(width_) * 4);
+
+    // the 16 bytes header ends with the color space, a small number.
+    // with a 12 bytes header, the last 4 bytes are the first pixel already, whose alpha is 255.
+    if (static_cast<uint8_t>(header_.back()) == 0xFF) {
+        return feed_pixels(std::string_view(header_).substr(12));
+    }
+    return true;
+}
+
+bool RawStreamDecoder::feed_pixels(std::string_view data)
+{
+    const size_t row_size = static_cast<size_t>(width_) * 4;
+
+    if (!row_.empty()) {
+        size_t count = std::min(row_size - row_.size(), data.size());
+        row_.append(data.substr(0, count));
+        data.remove_prefix(count);
+        if (row_.size() < row_size) {
+            return true;
+        }
+        convert_rows(row_.data(), 1);
+        row_.clear();
+    }
+
+    // whole rows are converted right from the received data
+    size_t rows = std::min(data.size() / row_size, static_cast<size_t>(height_ - next_row_));
+    if (rows != 0) {
+        convert_rows(data.data(), static_cast<int>(rows));
+        data.remove_prefix(rows * row_size);
+    }
+
+    if (data.empty()) {
+        return true;
+    }
+    if (next_row_ == height_) {
+        LogError << "more data than the image" << VAR(width_) << VAR(height_) << VAR(data.size());
+        failed_ = true;
+        return false;
+    }
+
+    row_.append(data);
+    return true;
+}
+
+void RawStreamDecoder::convert_rows(const char* data, int rows)
+{
+    cv::Mat src(rows, width_, CV_8UC4, const_cast<char*>(data));
+    cv::Mat dst = image_.rowRange(next_row_, next_row_ + rows);
+    cv::cvtColor(src, dst, cv::COLOR_RGBA2BGR);
+    next_row_ += rows;
+
+    if (next_row_ == height_) {
+        alpha_ok_ = src.at<cv::Vec4b>(rows - 1, width_ - 1)[3] == 255;
+    }
+}
+
+MAA_CTRL_UNIT_NS_END
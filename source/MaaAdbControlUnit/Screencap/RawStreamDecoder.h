@@ -0,0 +1,64 @@
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Conf/Conf.h"
+#include "Utils/NoWarningCVMat.hpp"
+
+struct z_stream_s;
+
+MAA_CTRL_UNIT_NS_BEGIN
+
+// Decodes the output of `screencap` (a 12 or 16 bytes header, then RGBA pixels) while it is being received.
+// Complete rows are converted to BGR straight into the destination image, so neither the whole output nor the whole
+// inflated data is ever held in memory.
+class RawStreamDecoder
+{
+public:
+    // clean_cr: the output went through a pipe which turned every `\n` into `\r\n`
+    RawStreamDecoder(bool gzip, bool clean_cr);
+    ~RawStreamDecoder();
+
+    RawStreamDecoder(const RawStreamDecoder&) = delete;
+    RawStreamDecoder& operator=(const RawStreamDecoder&) = delete;
+
+public:
+    // returns false once the data is known to be broken, the rest of it does not need to be read
+    bool feed(std::string_view data);
+    std::optional<cv::Mat> finish();
+
+    size_t received() const { return received_; }
+
+private:
+    bool feed_cleaned(std::string_view data);
+    bool feed_inflated(std::string_view data);
+    bool feed_header(std::string_view& data);
+    bool feed_pixels(std::string_view data);
+    void convert_rows(const char* data, int rows);
+
+private:
+    const bool clean_cr_ = false;
+    size_t received_ = 0;
+    bool pending_cr_ = false;
+    std::string cleaned_;
+
+    std::unique_ptr<z_stream_s> zs_;
+    bool inflate_end_ = false;
+    std::vector<char> inflated_;
+
+    std::string header_;
+    int width_ = 0;
+    int height_ = 0;
+    cv::Mat image_;
+    std::string row_;
+    int next_row_ = 0;
+    bool alpha_ok_ = false;
+
+    bool failed_ = false;
+};
+
+MAA_CTRL_UNIT_NS_END
@@ -20,6 +20,22 @@ std::optional<cv::Mat> ScreencapRawWithGzip::screencap()
         return std::nullopt;
     }
 
+    if (auto decoder = screencap_helper_.stream_decoder(true)) {
+        bool ret = startup_and_read_pipe(*argv_opt, [&](std::string_view chunk) { return decoder->feed(chunk); });
+
+        auto image_opt = decoder->finish();
+        if (image_opt) {
+            screencap_helper_.on_stream_succeeded();
+            return ret ? image_opt : std::nullopt;
+        }
+        // nothing received is a transfer problem rather than a decoding one
+        if (!ret || decoder->received() == 0) {
+            return std::nullopt;
+        }
+        // the data is consumed, this capture is taken again without streaming
+        screencap_helper_.on_stream_failed();
+    }
+
     auto output_opt = startup_and_read_pipe(*argv_opt);
     if (!output_opt) {
         return std::nullopt;
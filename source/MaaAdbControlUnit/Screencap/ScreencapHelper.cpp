@@ -85,6 +85,37 @@ std::optional<cv::Mat>
     return res;
 }
 
+std::unique_ptr<RawStreamDecoder> ScreencapHelper::stream_decoder(bool gzip) const
+{
+    if (stream_failures_ >= kMaxStreamFailures) {
+        return nullptr;
+    }
+
+    switch (end_of_line_) {
+    case EndOfLine::LF:
+        return std::make_unique<RawStreamDecoder>(gzip, false);
+    case EndOfLine::CRLF:
+        return std::make_unique<RawStreamDecoder>(gzip, true);
+    default:
+        return nullptr;
+    }
+}
+
+void ScreencapHelper::on_stream_succeeded()
+{
+    stream_failures_ = 0;
+}
+
+void ScreencapHelper::on_stream_failed()
+{
+    ++stream_failures_;
+    LogWarn << "streaming decode failed, fall back to process_data" << VAR(stream_failures_);
+
+    if (stream_failures_ >= kMaxStreamFailures) {
+        LogWarn << "streaming decode is disabled";
+    }
+}
+
 std::optional<cv::Mat> ScreencapHelper::decode_raw(const std::string& buffer)
 {
     if (buffer.size() < 8) {
@@ -114,8 +145,11 @@ std::optional<cv::Mat> ScreencapHelper::decode_raw(const std::string& buffer)
     if (br[3] != 255) { // only check alpha
         return std::nullopt;
     }
-    cv::cvtColor(temp, temp, cv::COLOR_RGBA2BGR);
-    return temp.clone(); // temp只是引用data, 需要clone确保数据拥有所有权
+    // temp只是引用data, 转换到新的 Mat 即拥有数据所有权, 不需要再 clone
+    // 转换仍在原分辨率上进行: 这里不知道目标尺寸, 而且这次转换本身就是取得所有权必须的那次拷贝
+    cv::Mat image;
+    cv::cvtColor(temp, image, cv::COLOR_RGBA2BGR);
+    return image;
 }
 
 std::optional<cv::Mat> ScreencapHelper::decode_gzip(const std::string& buffer)
@@ -5,6 +5,7 @@
 #include <string>
 
 #include "Conf/Conf.h"
+#include "RawStreamDecoder.h"
 #include "Utils/NoWarningCVMat.hpp"
 
 MAA_CTRL_UNIT_NS_BEGIN
@@ -14,6 +15,13 @@ class ScreencapHelper
 public:
     std::optional<cv::Mat> process_data(std::string& buffer, std::function<std::optional<cv::Mat>(const std::string& buffer)> decoder);
 
+    // streaming needs the end of line to be known, which is detected by process_data on the first captures.
+    // a capture that fails to stream is taken again through process_data. after kMaxStreamFailures failures in a row,
+    // streaming is not used anymore.
+    std::unique_ptr<RawStreamDecoder> stream_decoder(bool gzip) const;
+    void on_stream_succeeded();
+    void on_stream_failed();
+
     static std::optional<cv::Mat> decode_raw(const std::string& buffer);
     static std::optional<cv::Mat> decode_gzip(const std::string& buffer);
     static std::optional<cv::Mat> decode_png(const std::string& buffer);
@@ -32,6 +40,9 @@ private:
         LF,
         CR
     } end_of_line_ = EndOfLine::UnknownYet;
+
+    inline static constexpr int kMaxStreamFailures = 3;
+    int stream_failures_ = 0; // consecutive
 };
 
 MAA_CTRL_UNIT_NS_END
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+#include "Conf/Conf.h"
+#include "Utils/NonCopyable.hpp"
+
+MAA_NS_BEGIN
+
+// A thread-safe, bounded cache that evicts the least recently used item.
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class LRUCache : public NonCopyable
+{
+public:
+    explicit LRUCache(size_t capacity);
+
+    // counts a hit or a miss
+    std::optional<Value> get(const Key& key);
+    void put(Key key, Value value);
+    void clear();
+
+    size_t capacity() const { return capacity_; }
+
+    size_t hits() const { return hits_; }
+
+    size_t misses() const { return misses_; }
+
+private:
+    using Item = std::pair<Key, Value>;
+
+    const size_t capacity_ = 0;
+
+    // most recently used first
+    std::list<Item> items_;
+    std::unordered_map<Key, typename std::list<Item>::iterator, Hash> index_;
+    std::mutex mutex_;
+
+    std::atomic_size_t hits_ = 0;
+    std::atomic_size_t misses_ = 0;
+};
+
+template <typename Key, typename Value, typename Hash>
+inline LRUCache<Key, Value, Hash>::LRUCache(size_t capacity)
+    : capacity_(capacity == 0 ? 1 : capacity)
+{
+}
+
+template <typename Key, typename Value, typename Hash>
+inline std::optional<Value> LRUCache<Key, Value, Hash>::get(const Key& key)
+{
+    std::unique_lock lock(mutex_);
+
+    auto iter = index_.find(key);
+    if (iter == index_.end()) {
+        ++misses_;
+        return std::nullopt;
+    }
+
+    ++hits_;
+    items_.splice(items_.begin(), items_, iter->second);
+    return iter->second->second;
+}
+
+template <typename Key, typename Value, typename Hash>
+inline void LRUCache<Key, Value, Hash>::put(Key key, Value value)
+{
+    std::unique_lock lock(mutex_);
+
+    if (auto iter = index_.find(key); iter != index_.end()) {
+        iter->second->second = std::move(value);
+        items_.splice(items_.begin(), items_, iter->second);
+        return;
+    }
+
+    if (items_.size() >= capacity_) {
+        index_.erase(items_.back().first);
+        items_.pop_back();
+    }
+
+    items_.emplace_front(key, std::move(value));
+    index_.emplace(std::move(key), items_.begin());
+}
+
+template <typename Key, typename Value, typename Hash>
+inline void LRUCache<Key, Value, Hash>::clear()
+{
+    std::unique_lock lock(mutex_);
+
+    items_.clear();
+    index_.clear();
+}
+
+MAA_NS_END
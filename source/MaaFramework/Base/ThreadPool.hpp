@@ -0,0 +1,122 @@
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "Conf/Conf.h"
+#include "Utils/Logger.h"
+#include "Utils/NonCopyable.hpp"
+
+MAA_NS_BEGIN
+
+class ThreadPool : public NonCopyable
+{
+public:
+    using Job = std::function<void()>;
+
+public:
+    explicit ThreadPool(size_t size = default_size());
+    virtual ~ThreadPool();
+
+    template <typename Func>
+    auto submit(Func&& func) -> std::future<std::invoke_result_t<Func>>;
+
+    size_t size() const { return workers_.size(); }
+
+    static size_t default_size();
+
+private:
+    void working();
+
+    std::list<Job> queue_;
+    std::mutex queue_mutex_;
+    std::condition_variable queue_cond_;
+
+    bool exit_ = false;
+
+    std::vector<std::thread> workers_;
+};
+
+inline ThreadPool::ThreadPool(size_t size)
+{
+    LogFunc << VAR(size);
+
+    if (size == 0) {
+        size = 1;
+    }
+
+    workers_.reserve(size);
+    for (size_t i = 0; i != size; ++i) {
+        workers_.emplace_back(&ThreadPool::working, this);
+    }
+}
+
+inline ThreadPool::~ThreadPool()
+{
+    LogFunc;
+
+    {
+        std::unique_lock queue_lock(queue_mutex_);
+        exit_ = true;
+        queue_cond_.notify_all();
+    }
+
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+template <typename Func>
+inline auto ThreadPool::submit(Func&& func) -> std::future<std::invoke_result_t<Func>>
+{
+    using Ret = std::invoke_result_t<Func>;
+
+    // std::function requires a copyable target, so the packaged_task is kept in a shared_ptr
+    auto task = std::make_shared<std::packaged_task<Ret()>>(std::forward<Func>(func));
+    auto future = task->get_future();
+
+    {
+        std::unique_lock queue_lock(queue_mutex_);
+        queue_.emplace_back([task]() { (*task)(); });
+        queue_cond_.notify_one();
+    }
+
+    return future;
+}
+
+inline size_t ThreadPool::default_size()
+{
+    constexpr size_t kMaxSize = 8;
+
+    size_t hardware = std::thread::hardware_concurrency();
+    return std::clamp<size_t>(hardware, 1, kMaxSize);
+}
+
+inline void ThreadPool::working()
+{
+    while (true) {
+        std::unique_lock queue_lock(queue_mutex_);
+        queue_cond_.wait(queue_lock, [&]() { return exit_ || !queue_.empty(); });
+
+        // drain the queue before exiting, so that no future is left without a value
+        if (queue_.empty()) {
+            return;
+        }
+
+        Job job = std::move(queue_.front());
+        queue_.pop_front();
+        queue_lock.unlock();
+
+        job();
+    }
+}
+
+MAA_NS_END
@@ -2,6 +2,7 @@
 
 #include "Global/GlobalOptionMgr.h"
 #include "MaaFramework/MaaMsg.h"
+#include "RecordingWriter.h"
 #include "Resource/ResourceMgr.h"
 #include "Utils/ImageIo.h"
 #include "Utils/NoWarningCV.hpp"
@@ -23,6 +24,8 @@ ControllerAgent::~ControllerAgent()
 {
     LogFunc;
 
+    stop_streaming();
+
     if (action_runner_) {
         action_runner_->wait_all();
     }
@@ -41,6 +44,8 @@ bool ControllerAgent::set_option(MaaCtrlOption key, MaaOptionValue value, MaaOpt
         return set_image_use_raw_size(value, val_size);
     case MaaCtrlOption_Recording:
         return set_recording(value, val_size);
+    case MaaCtrlOption_ScreencapStreaming:
+        return set_screencap_streaming(value, val_size);
 
     default:
         LogError << "Unknown key" << VAR(key) << VAR(value);
@@ -155,6 +160,8 @@ bool ControllerAgent::connected() const
 
 cv::Mat ControllerAgent::cached_image() const
 {
+    // the streaming thread may be replacing it
+    std::unique_lock lock(screencap_mutex_);
     return image_;
 }
 
@@ -175,6 +182,12 @@ void ControllerAgent::post_stop()
     if (action_runner_ && action_runner_->running()) {
         action_runner_->clear();
     }
+
+    {
+        // wake up the streaming screencaps
+        std::unique_lock lock(stream_mutex_);
+        stream_cond_.notify_all();
+    }
 }
 
 bool ControllerAgent::running() const
@@ -238,12 +251,64 @@ bool ControllerAgent::input_text(const std::string& text)
 
 cv::Mat ControllerAgent::screencap()
 {
+    if (int max_age = screencap_streaming_; max_age > 0) {
+        return screencap(std::chrono::milliseconds(max_age));
+    }
+
     std::unique_lock lock(image_mutex_);
     auto id = post_screencap_impl();
     if (wait(id) != MaaStatus_Succeeded) {
         return {};
     }
-    return image_.clone();
+    // postproc_screenshot never writes into a published image, so it can be shared
+    std::unique_lock screencap_lock(screencap_mutex_);
+    return image_;
+}
+
+cv::Mat ControllerAgent::screencap(std::chrono::milliseconds max_age)
+{
+    if (!check_stop()) {
+        return {};
+    }
+    if (!connected_) {
+        LogError << "controller not connected";
+        return {};
+    }
+
+    start_streaming();
+
+    const auto request_time = std::chrono::steady_clock::now();
+    auto newest = [&]() -> const StreamFrame* {
+        return stream_seq_ == 0 ? nullptr : &stream_ring_[(stream_seq_ - 1) % stream_ring_.size()];
+    };
+    auto fresh = [&]() {
+        const StreamFrame* frame = newest();
+        return frame && frame->time + max_age >= request_time;
+    };
+
+    StreamFrame frame;
+    {
+        std::unique_lock lock(stream_mutex_);
+
+        stream_last_demand_ = request_time;
+        stream_cond_.notify_all();
+
+        uint64_t failures = stream_failures_;
+        stream_cond_.wait(lock, [&]() { return fresh() || stream_failures_ != failures || stream_exit_ || need_to_stop_; });
+
+        if (!fresh()) {
+            LogError << "streaming screencap failed" << VAR(max_age.count()) << VAR(stream_failures_) << VAR(stream_exit_)
+                     << VAR(need_to_stop_);
+            return {};
+        }
+        frame = *newest();
+    }
+
+    if (recording()) {
+        record_stream_frame(frame);
+    }
+
+    return frame.image;
 }
 
 bool ControllerAgent::start_app(const std::string& package)
@@ -535,28 +600,129 @@ bool ControllerAgent::handle_screencap()
         start_time = std::chrono::steady_clock::now();
     }
 
+    cv::Mat raw_image;
+    cv::Mat image;
+    bool ret = capture(raw_image, image);
+
+    if (recording() && !raw_image.empty()) {
+        auto image_relative_path = path("screenshot") / path(format_now_for_filename() + ".png");
+        json::value info = {
+            { "type", "screencap" },
+            { "path", path_to_utf8_string(image_relative_path) },
+        };
+        append_recording(std::move(info), start_time, ret, std::move(image_relative_path), std::move(raw_image));
+    }
+
+    return ret;
+}
+
+bool ControllerAgent::capture(cv::Mat& raw_image, cv::Mat& image)
+{
+    std::unique_lock lock(screencap_mutex_);
+
     auto opt = _screencap();
     if (!opt) {
         LogError << "controller screencap failed";
         return false;
     }
 
-    cv::Mat raw_image = std::move(*opt);
+    raw_image = std::move(*opt);
     bool ret = postproc_screenshot(raw_image);
+    image = image_;
+    return ret;
+}
 
-    if (recording()) {
-        auto image_relative_path = path("screenshot") / path(format_now_for_filename() + ".png");
-        auto image_path = recording_path_.parent_path() / image_relative_path;
-        MAA_NS::imwrite(image_path, raw_image);
+void ControllerAgent::start_streaming()
+{
+    std::unique_lock lock(stream_thread_mutex_);
 
-        json::value info = {
-            { "type", "screencap" },
-            { "path", path_to_utf8_string(image_relative_path) },
-        };
-        append_recording(std::move(info), start_time, ret);
+    if (stream_thread_.joinable()) {
+        return;
     }
 
-    return ret;
+    LogInfo << VAR(screencap_streaming_);
+
+    {
+        std::unique_lock stream_lock(stream_mutex_);
+        stream_exit_ = false;
+    }
+    stream_thread_ = std::thread(&ControllerAgent::streaming, this);
+}
+
+void ControllerAgent::stop_streaming()
+{
+    std::unique_lock lock(stream_thread_mutex_);
+
+    if (!stream_thread_.joinable()) {
+        return;
+    }
+
+    LogFunc;
+
+    {
+        std::unique_lock stream_lock(stream_mutex_);
+        stream_exit_ = true;
+        stream_cond_.notify_all();
+    }
+    stream_thread_.join();
+}
+
+void ControllerAgent::streaming()
+{
+    LogFunc;
+
+    // stop capturing when no one has asked for a frame for a while, and wait for the next request
+    constexpr auto kIdleTimeout = std::chrono::seconds(5);
+    constexpr auto kRetryInterval = std::chrono::milliseconds(100);
+
+    while (true) {
+        {
+            std::unique_lock lock(stream_mutex_);
+            stream_cond_.wait(lock, [&]() {
+                return stream_exit_ || std::chrono::steady_clock::now() - stream_last_demand_ < kIdleTimeout;
+            });
+            if (stream_exit_) {
+                return;
+            }
+        }
+
+        StreamFrame frame { .time = std::chrono::steady_clock::now() };
+        cv::Mat raw_image;
+        bool ret = capture(raw_image, frame.image);
+        if (recording()) {
+            frame.raw = std::move(raw_image);
+        }
+
+        std::unique_lock lock(stream_mutex_);
+
+        if (ret) {
+            frame.seq = ++stream_seq_;
+            stream_ring_[(frame.seq - 1) % stream_ring_.size()] = std::move(frame);
+        }
+        else {
+            ++stream_failures_;
+        }
+        stream_cond_.notify_all();
+
+        if (!ret) {
+            stream_cond_.wait_for(lock, kRetryInterval, [&]() { return stream_exit_; });
+        }
+    }
+}
+
+void ControllerAgent::record_stream_frame(const StreamFrame& frame)
+{
+    // recording was turned on after the capture
+    if (frame.raw.empty()) {
+        return;
+    }
+
+    auto image_relative_path = path("screenshot") / path(format_now_for_filename() + ".png");
+    json::value info = {
+        { "type", "screencap" },
+        { "path", path_to_utf8_string(image_relative_path) },
+    };
+    append_recording(std::move(info), frame.time, true, std::move(image_relative_path), frame.raw);
 }
 
 bool ControllerAgent::handle_start_app(const AppParam& param)
@@ -599,13 +765,26 @@ bool ControllerAgent::recording() const
 }
 
 void ControllerAgent::init_recording()
+{
+    auto writer = make_recording_writer();
+
+    std::unique_lock lock(recording_mutex_);
+    recording_writer_ = std::move(writer);
+}
+
+std::shared_ptr<RecordingWriter> ControllerAgent::make_recording_writer()
 {
     auto recording_dir = GlobalOptionMgr::get_instance().log_dir() / "recording";
-    std::filesystem::create_directories(recording_dir);
-    recording_path_ = recording_dir / std::format("maa_recording_{}.txt", format_now_for_filename());
+    auto recording_path = recording_dir / std::format("maa_recording_{}.txt", format_now_for_filename());
+    return std::make_shared<RecordingWriter>(std::move(recording_path));
 }
 
-void ControllerAgent::append_recording(json::value info, const std::chrono::steady_clock::time_point& start_time, bool success)
+void ControllerAgent::append_recording(
+    json::value info,
+    const std::chrono::steady_clock::time_point& start_time,
+    bool success,
+    std::filesystem::path image_relative_path,
+    cv::Mat image)
 {
     if (!recording()) {
         return;
@@ -615,9 +794,18 @@ void ControllerAgent::append_recording(json::value info, const std::chrono::stea
     info["cost"] = duration_since(start_time).count();
     info["success"] = success;
 
-    std::ofstream ofs(recording_path_, std::ios::app);
-    ofs << info.to_string() << "\n";
-    ofs.close();
+    std::shared_ptr<RecordingWriter> writer;
+    {
+        // the action thread and the streaming thread both get here, only one of them may create the writer
+        std::unique_lock lock(recording_mutex_);
+        if (!recording_writer_) {
+            // recording was turned on after connecting
+            recording_writer_ = make_recording_writer();
+        }
+        writer = recording_writer_;
+    }
+
+    writer->append(std::move(info), std::move(image_relative_path), std::move(image));
 }
 
 bool ControllerAgent::check_stop()
@@ -776,7 +964,26 @@ bool ControllerAgent::postproc_screenshot(const cv::Mat& raw)
         }
     }
 
-    cv::resize(raw, image_, { image_target_width_, image_target_height_ });
+    // the screenshots handed out share their pixels, so always produce a new buffer instead of writing into the previous one
+    cv::Mat image;
+    if (raw.cols == image_target_width_ && raw.rows == image_target_height_) {
+        image = raw;
+    }
+    else {
+        cv::resize(raw, image, { image_target_width_, image_target_height_ });
+    }
+
+    // BGRA or gray screenshots (e.g. from custom controllers) are converted after downscaling, on fewer pixels.
+    // resize works on each channel independently, so the order does not change the result.
+    // the adb raw decoders hand over BGR already, their RGBA conversion is the copy out of the pipe buffer.
+    if (image.channels() == 4) {
+        cv::cvtColor(image, image, cv::COLOR_BGRA2BGR);
+    }
+    else if (image.channels() == 1) {
+        cv::cvtColor(image, image, cv::COLOR_GRAY2BGR);
+    }
+
+    image_ = image;
     return !image_.empty();
 }
 
@@ -911,6 +1118,27 @@ bool ControllerAgent::set_recording(MaaOptionValue value, MaaOptionValueSize val
     return true;
 }
 
+bool ControllerAgent::set_screencap_streaming(MaaOptionValue value, MaaOptionValueSize val_size)
+{
+    if (val_size != sizeof(int)) {
+        LogError << "invalid value size: " << val_size;
+        return false;
+    }
+    int max_age = *reinterpret_cast<int*>(value);
+    if (max_age < 0) {
+        LogError << "invalid value: " << max_age;
+        return false;
+    }
+    screencap_streaming_ = max_age;
+
+    if (screencap_streaming_ == 0) {
+        stop_streaming();
+    }
+
+    LogInfo << VAR(screencap_streaming_);
+    return true;
+}
+
 std::ostream& operator<<(std::ostream& os, const Action& action)
 {
     switch (action.type) {
@@ -1,9 +1,14 @@
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <memory>
 #include <mutex>
 #include <random>
 #include <set>
+#include <thread>
 #include <variant>
 
 #include <meojson/json.hpp>
@@ -19,6 +24,8 @@ MAA_RES_NS_END
 
 MAA_CTRL_NS_BEGIN
 
+class RecordingWriter;
+
 struct ClickParam
 {
     int x = 0;
@@ -148,6 +155,8 @@ public:
     bool press_key(int keycode);
     bool input_text(const std::string& text);
     cv::Mat screencap();
+    // the newest frame of the streaming capture, captured no earlier than `max_age` before this call
+    cv::Mat screencap(std::chrono::milliseconds max_age);
 
     bool start_app(const std::string& package);
     bool stop_app(const std::string& package);
@@ -167,6 +176,10 @@ protected:
     virtual bool _press_key(PressKeyParam param) = 0;
     virtual bool _input_text(InputTextParam param) = 0;
 
+protected:
+    // derived classes must call it in their destructors, the streaming thread calls _screencap
+    void stop_streaming();
+
 protected:
     MessageNotifier notifier_;
 
@@ -200,7 +213,13 @@ private:
 
     bool recording() const;
     void init_recording();
-    void append_recording(json::value info, const std::chrono::steady_clock::time_point& start_time, bool success);
+    static std::shared_ptr<RecordingWriter> make_recording_writer();
+    void append_recording(
+        json::value info,
+        const std::chrono::steady_clock::time_point& start_time,
+        bool success,
+        std::filesystem::path image_relative_path = {},
+        cv::Mat image = {});
 
     MaaCtrlId post(Action action);
     void focus_id(MaaCtrlId id);
@@ -212,6 +231,7 @@ private:
     bool run_action(typename AsyncRunner<Action>::Id id, Action action);
     std::pair<int, int> preproc_touch_point(int x, int y);
     bool postproc_screenshot(const cv::Mat& raw);
+    bool capture(cv::Mat& raw_image, cv::Mat& image);
     bool calc_target_image_size();
     void clear_target_image_size();
     bool request_uuid();
@@ -222,9 +242,23 @@ private: // options
     bool set_image_target_short_side(MaaOptionValue value, MaaOptionValueSize val_size);
     bool set_image_use_raw_size(MaaOptionValue value, MaaOptionValueSize val_size);
     bool set_recording(MaaOptionValue value, MaaOptionValueSize val_size);
+    bool set_screencap_streaming(MaaOptionValue value, MaaOptionValueSize val_size);
+
+private: // streaming
+    struct StreamFrame
+    {
+        cv::Mat image;
+        cv::Mat raw; // only kept when recording
+        std::chrono::steady_clock::time_point time; // when the capture started
+        uint64_t seq = 0;
+    };
+
+    void start_streaming();
+    void streaming();
+    void record_stream_frame(const StreamFrame& frame);
 
 private:
-    bool need_to_stop_ = false;
+    std::atomic_bool need_to_stop_ = false;
 
 private:
     static std::minstd_rand rand_engine_;
@@ -243,8 +277,23 @@ private:
 
     std::string uuid_cache_;
 
+    // serializes _screencap and postproc_screenshot between the action thread and the streaming thread
+    mutable std::mutex screencap_mutex_;
+
+    std::atomic_int screencap_streaming_ = 0; // max age in ms, 0 for disabled
+    std::thread stream_thread_;
+    std::mutex stream_thread_mutex_;
+    std::mutex stream_mutex_;
+    std::condition_variable stream_cond_;
+    bool stream_exit_ = false;
+    std::array<StreamFrame, 3> stream_ring_;
+    uint64_t stream_seq_ = 0;
+    uint64_t stream_failures_ = 0;
+    std::chrono::steady_clock::time_point stream_last_demand_;
+
     bool recording_ = false;
-    std::filesystem::path recording_path_;
+    std::shared_ptr<RecordingWriter> recording_writer_;
+    std::mutex recording_mutex_;
 
     std::set<AsyncRunner<Action>::Id> focus_ids_;
     std::mutex focus_ids_mutex_;
@@ -24,6 +24,11 @@ CustomControllerAgent::CustomControllerAgent(
              << VAR_VOIDP(controller->press_key) << VAR_VOIDP(controller->input_text);
 }
 
+CustomControllerAgent::~CustomControllerAgent()
+{
+    stop_streaming();
+}
+
 bool CustomControllerAgent::_connect()
 {
     LogFunc << VAR_VOIDP(controller_) << VAR_VOIDP(controller_->connect);
@@ -13,7 +13,7 @@ public:
         void* controller_arg,
         MaaNotificationCallback notify,
         void* notify_trans_arg);
-    virtual ~CustomControllerAgent() override = default;
+    virtual ~CustomControllerAgent() override;
 
 protected:
     virtual bool _connect() override;
@@ -17,6 +17,11 @@ GeneralControllerAgent::GeneralControllerAgent(
 {
 }
 
+GeneralControllerAgent::~GeneralControllerAgent()
+{
+    stop_streaming();
+}
+
 bool GeneralControllerAgent::_connect()
 {
     LogFunc;
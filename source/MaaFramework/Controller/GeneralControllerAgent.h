@@ -14,7 +14,7 @@ public:
         std::shared_ptr<MAA_CTRL_UNIT_NS::ControlUnitAPI> control_unit,
         MaaNotificationCallback notify,
         void* notify_trans_arg);
-    virtual ~GeneralControllerAgent() override = default;
+    virtual ~GeneralControllerAgent() override;
 
 protected:
     virtual bool _connect() override;
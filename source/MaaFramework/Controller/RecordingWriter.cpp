@@ -0,0 +1,105 @@
+#include "RecordingWriter.h"
+
+#include "Utils/ImageIo.h"
+#include "Utils/Logger.h"
+#include "Utils/Time.hpp"
+
+MAA_CTRL_NS_BEGIN
+
+RecordingWriter::RecordingWriter(std::filesystem::path path)
+    : path_(std::move(path))
+{
+    LogFunc << VAR(path_);
+
+    if (path_.has_parent_path()) {
+        std::filesystem::create_directories(path_.parent_path());
+    }
+    ofs_.open(path_, std::ios::out | std::ios::app);
+    if (!ofs_.is_open()) {
+        LogError << "failed to open recording" << VAR(path_);
+    }
+
+    thread_ = std::thread(&RecordingWriter::working, this);
+}
+
+RecordingWriter::~RecordingWriter()
+{
+    {
+        std::unique_lock lock(queue_mutex_);
+        exit_ = true;
+        queue_cond_.notify_all();
+    }
+
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    LogInfo << VAR(path_) << VAR(written_) << VAR(blocked_) << VAR(blocked_time_);
+}
+
+void RecordingWriter::append(json::value record, std::filesystem::path image_path, cv::Mat image)
+{
+    std::unique_lock lock(queue_mutex_);
+
+    if (!image.empty() && pending_images_ >= kMaxPendingImages) {
+        auto start_time = std::chrono::steady_clock::now();
+        space_cond_.wait(lock, [&]() { return exit_ || pending_images_ < kMaxPendingImages; });
+
+        ++blocked_;
+        blocked_time_ += duration_since(start_time);
+    }
+
+    if (!image.empty()) {
+        ++pending_images_;
+    }
+    queue_.emplace_back(Item { .record = std::move(record), .image_path = std::move(image_path), .image = std::move(image) });
+    queue_cond_.notify_one();
+}
+
+void RecordingWriter::working()
+{
+    while (true) {
+        std::unique_lock lock(queue_mutex_);
+        queue_cond_.wait(lock, [&]() { return exit_ || !queue_.empty(); });
+
+        // drain the queue before exiting, the recording must be complete
+        if (queue_.empty()) {
+            return;
+        }
+
+        std::deque<Item> items;
+        items.swap(queue_);
+        lock.unlock();
+
+        for (const Item& item : items) {
+            write(item);
+
+            if (!item.image.empty()) {
+                std::unique_lock space_lock(queue_mutex_);
+                --pending_images_;
+                space_cond_.notify_all();
+            }
+        }
+
+        // flushed once per batch, so that the records survive a crash without paying a flush for each of them
+        ofs_.flush();
+    }
+}
+
+void RecordingWriter::write(const Item& item)
+{
+    if (!item.image.empty()) {
+        // the fastest zlib level, screenshots are large and written on every screencap
+        static const std::vector<int> kPngParams = { cv::IMWRITE_PNG_COMPRESSION, 1 };
+
+        auto image_path = path_.parent_path() / item.image_path;
+        if (!MAA_NS::imwrite(image_path, item.image, kPngParams)) {
+            LogError << "failed to write image" << VAR(image_path);
+        }
+    }
+
+    ofs_ << item.record.to_string() << "\n";
+    ++written_;
+}
+
+MAA_CTRL_NS_END
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <thread>
+
+#include <meojson/json.hpp>
+
+#include "Conf/Conf.h"
+#include "Utils/NoWarningCVMat.hpp"
+#include "Utils/NonCopyable.hpp"
+
+MAA_CTRL_NS_BEGIN
+
+// Writes the records of a recording, and the screenshots they refer to, on a background thread.
+// At most kMaxPendingImages screenshots are queued. Beyond that, append() blocks until the writer catches up rather than dropping
+// anything, so a record never refers to a missing screenshot. How often and how long it blocked is logged on destruction.
+// Neither the encoder nor the blocking is configurable on purpose: a recording is replayed by ReplayRecording, which feeds
+// the screenshots to the recognitions again. A dropped one breaks the replay, and a lossy one changes its scores.
+class RecordingWriter : public NonCopyable
+{
+public:
+    inline static constexpr size_t kMaxPendingImages = 8;
+
+public:
+    explicit RecordingWriter(std::filesystem::path path);
+    ~RecordingWriter();
+
+    // `image` is written to `image_path`, relative to the directory of the recording, before the record itself
+    void append(json::value record, std::filesystem::path image_path = {}, cv::Mat image = {});
+
+    const std::filesystem::path& path() const { return path_; }
+
+private:
+    struct Item
+    {
+        json::value record;
+        std::filesystem::path image_path;
+        cv::Mat image;
+    };
+
+    void working();
+    void write(const Item& item);
+
+    const std::filesystem::path path_;
+    std::ofstream ofs_;
+
+    std::deque<Item> queue_;
+    size_t pending_images_ = 0;
+    std::mutex queue_mutex_;
+    std::condition_variable queue_cond_;
+    std::condition_variable space_cond_;
+    bool exit_ = false;
+
+    size_t written_ = 0;
+    size_t blocked_ = 0;
+    std::chrono::milliseconds blocked_time_ {};
+
+    std::thread thread_;
+};
+
+MAA_CTRL_NS_END
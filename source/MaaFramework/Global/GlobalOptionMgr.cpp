@@ -18,6 +18,14 @@ bool GlobalOptionMgr::set_option(MaaGlobalOption key, MaaOptionValue value, MaaO
         return set_recording(value, val_size);
     case MaaGlobalOption_StdoutLevel:
         return set_stdout_level(value, val_size);
+    case MaaGlobalOption_FileLevel:
+        return set_file_level(value, val_size);
+    case MaaGlobalOption_LogImageFormat:
+        return set_log_image_format(value, val_size);
+    case MaaGlobalOption_LogImageRateLimit:
+        return set_log_image_rate_limit(value, val_size);
+    case MaaGlobalOption_LogImageQuality:
+        return set_log_image_quality(value, val_size);
     case MaaGlobalOption_ShowHitDraw:
         return set_show_hit_draw(value, val_size);
     case MaaGlobalOption_DebugMode:
@@ -108,6 +116,82 @@ bool GlobalOptionMgr::set_stdout_level(MaaOptionValue value, MaaOptionValueSize
     return true;
 }
 
+bool GlobalOptionMgr::set_file_level(MaaOptionValue value, MaaOptionValueSize val_size)
+{
+    LogFunc;
+
+    if (val_size != sizeof(MaaLoggingLevel)) {
+        LogError << "Invalid value size" << VAR(val_size);
+        return false;
+    }
+
+    MaaLoggingLevel level = *reinterpret_cast<const MaaLoggingLevel*>(value);
+
+    LogInfo << "Set log file level" << VAR(level);
+
+    MAA_LOG_NS::Logger::get_instance().set_file_level(level);
+
+    return true;
+}
+
+bool GlobalOptionMgr::set_log_image_format(MaaOptionValue value, MaaOptionValueSize val_size)
+{
+    LogFunc;
+
+    std::string_view format(reinterpret_cast<const char*>(value), val_size);
+
+    if (!MAA_LOG_NS::Logger::get_instance().set_image_format(format)) {
+        LogError << "Invalid log image format" << VAR(format);
+        return false;
+    }
+
+    LogInfo << "Set log image format" << VAR(format);
+
+    return true;
+}
+
+bool GlobalOptionMgr::set_log_image_quality(MaaOptionValue value, MaaOptionValueSize val_size)
+{
+    LogFunc;
+
+    if (val_size != sizeof(int)) {
+        LogError << "Invalid value size" << VAR(val_size);
+        return false;
+    }
+
+    int quality = *reinterpret_cast<const int*>(value);
+
+    if (!MAA_LOG_NS::Logger::get_instance().set_image_quality(quality)) {
+        LogError << "Invalid log image quality" << VAR(quality);
+        return false;
+    }
+
+    LogInfo << "Set log image quality" << VAR(quality);
+
+    return true;
+}
+
+bool GlobalOptionMgr::set_log_image_rate_limit(MaaOptionValue value, MaaOptionValueSize val_size)
+{
+    LogFunc;
+
+    if (val_size != sizeof(int)) {
+        LogError << "Invalid value size" << VAR(val_size);
+        return false;
+    }
+
+    int rate_limit = *reinterpret_cast<const int*>(value);
+
+    if (!MAA_LOG_NS::Logger::get_instance().set_image_rate_limit(rate_limit)) {
+        LogError << "Invalid log image rate limit" << VAR(rate_limit);
+        return false;
+    }
+
+    LogInfo << "Set log image rate limit" << VAR(rate_limit);
+
+    return true;
+}
+
 bool GlobalOptionMgr::set_debug_mode(MaaOptionValue value, MaaOptionValueSize val_size)
 {
     LogFunc;
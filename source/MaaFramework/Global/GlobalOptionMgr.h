@@ -39,6 +39,10 @@ private:
     bool set_show_hit_draw(MaaOptionValue value, MaaOptionValueSize val_size);
     bool set_recording(MaaOptionValue value, MaaOptionValueSize val_size);
     bool set_stdout_level(MaaOptionValue value, MaaOptionValueSize val_size);
+    bool set_file_level(MaaOptionValue value, MaaOptionValueSize val_size);
+    bool set_log_image_format(MaaOptionValue value, MaaOptionValueSize val_size);
+    bool set_log_image_quality(MaaOptionValue value, MaaOptionValueSize val_size);
+    bool set_log_image_rate_limit(MaaOptionValue value, MaaOptionValueSize val_size);
     bool set_debug_mode(MaaOptionValue value, MaaOptionValueSize val_size);
 
 private:
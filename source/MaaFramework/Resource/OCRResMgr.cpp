@@ -1,8 +1,10 @@
 #include "OCRResMgr.h"
 
 #include <filesystem>
+#include <optional>
 #include <ranges>
 
+#include "Base/ThreadPool.hpp"
 #include "Utils/File.hpp"
 #include "Utils/Logger.h"
 #include "Utils/Platform.h"
@@ -71,13 +73,31 @@ void OCRResMgr::clear()
     LogFunc;
 
     roots_.clear();
-    deters_.clear();
-    recers_.clear();
-    ocrers_.clear();
+    {
+        std::unique_lock lock(deters_mutex_);
+        deters_.clear();
+    }
+    {
+        std::unique_lock lock(recers_mutex_);
+        recers_.clear();
+    }
+    {
+        std::unique_lock lock(ocrers_mutex_);
+        ocrers_.clear();
+    }
+    {
+        std::unique_lock lock(models_mutex_);
+        idle_models_.clear();
+        loaded_models_.clear();
+        ++generation_;
+        models_cond_.notify_all();
+    }
 }
 
 std::shared_ptr<fastdeploy::vision::ocr::DBDetector> OCRResMgr::deter(const std::string& name)
 {
+    std::unique_lock lock(deters_mutex_);
+
     if (auto iter = deters_.find(name); iter != deters_.end()) {
         return iter->second;
     }
@@ -92,6 +112,8 @@ std::shared_ptr<fastdeploy::vision::ocr::DBDetector> OCRResMgr::deter(const std:
 
 std::shared_ptr<fastdeploy::vision::ocr::Recognizer> OCRResMgr::recer(const std::string& name)
 {
+    std::unique_lock lock(recers_mutex_);
+
     if (auto iter = recers_.find(name); iter != recers_.end()) {
         return iter->second;
     }
@@ -106,6 +128,8 @@ std::shared_ptr<fastdeploy::vision::ocr::Recognizer> OCRResMgr::recer(const std:
 
 std::shared_ptr<fastdeploy::pipeline::PPOCRv3> OCRResMgr::ocrer(const std::string& name)
 {
+    std::unique_lock lock(ocrers_mutex_);
+
     if (auto iter = ocrers_.find(name); iter != ocrers_.end()) {
         return iter->second;
     }
@@ -118,6 +142,78 @@ std::shared_ptr<fastdeploy::pipeline::PPOCRv3> OCRResMgr::ocrer(const std::strin
     return ocrer;
 }
 
+std::shared_ptr<const OCRResMgr::Models> OCRResMgr::borrow(const std::string& name)
+{
+    std::optional<Models> models;
+    bool first = false;
+    uint64_t generation = 0;
+    {
+        std::unique_lock lock(models_mutex_);
+
+        // the cached instance, and one for each thread of Tasker::reco_pool()
+        const size_t max_models = 1 + ThreadPool::default_size();
+        auto can_borrow = [&]() {
+            return !idle_models_[name].empty() || loaded_models_[name] < max_models;
+        };
+        if (!can_borrow()) {
+            LogDebug << "all instances are busy, wait for one" << VAR(name) << VAR(max_models);
+            models_cond_.wait(lock, can_borrow);
+        }
+
+        generation = generation_;
+        if (auto& idle = idle_models_[name]; !idle.empty()) {
+            models = std::move(idle.back());
+            idle.pop_back();
+        }
+        else {
+            first = loaded_models_[name]++ == 0;
+        }
+    }
+
+    if (!models) {
+        if (first) {
+            models = Models { .deter = deter(name), .recer = recer(name), .ocrer = ocrer(name) };
+        }
+        else {
+            LogInfo << "all instances are busy, load another one" << VAR(name);
+            models = load_models(name);
+        }
+    }
+
+    return std::shared_ptr<const Models>(new Models(std::move(*models)), [this, name, generation](const Models* p) {
+        give_back(name, generation, p);
+    });
+}
+
+OCRResMgr::Models OCRResMgr::load_models(const std::string& name)
+{
+    Models models { .deter = load_deter(name), .recer = load_recer(name) };
+    if (!models.deter || !models.recer) {
+        return models;
+    }
+
+    auto ocr = std::make_shared<fastdeploy::pipeline::PPOCRv3>(models.deter.get(), models.recer.get());
+    if (!ocr->Initialized()) {
+        LogError << "Failed to load PPOCRv3:" << VAR(name);
+        return models;
+    }
+    models.ocrer = std::move(ocr);
+    return models;
+}
+
+void OCRResMgr::give_back(const std::string& name, uint64_t generation, const Models* models)
+{
+    std::unique_ptr<const Models> holder(models);
+
+    std::unique_lock lock(models_mutex_);
+    if (generation != generation_) {
+        return;
+    }
+    idle_models_[name].emplace_back(*holder);
+    // waiters of other models share the condition
+    models_cond_.notify_all();
+}
+
 std::shared_ptr<fastdeploy::vision::ocr::DBDetector> OCRResMgr::load_deter(const std::string& name)
 {
     using namespace path_literals;
@@ -1,6 +1,10 @@
 #pragma once
 
+#include <condition_variable>
 #include <filesystem>
+#include <memory>
+#include <mutex>
+#include <vector>
 
 #include "Conf/Conf.h"
 
@@ -21,6 +25,14 @@ MAA_RES_NS_BEGIN
 
 class OCRResMgr : public NonCopyable
 {
+public:
+    struct Models
+    {
+        std::shared_ptr<fastdeploy::vision::ocr::DBDetector> deter;
+        std::shared_ptr<fastdeploy::vision::ocr::Recognizer> recer;
+        std::shared_ptr<fastdeploy::pipeline::PPOCRv3> ocrer;
+    };
+
 public:
     OCRResMgr();
 
@@ -37,7 +49,16 @@ public:
     std::shared_ptr<fastdeploy::vision::ocr::Recognizer> recer(const std::string& name);
     std::shared_ptr<fastdeploy::pipeline::PPOCRv3> ocrer(const std::string& name);
 
+    // fastdeploy models keep their I/O tensors as members, so one instance must not run inference concurrently.
+    // A recognition borrows an instance of its own, which goes back to the pool when the pointer is released.
+    // The first instance of a model is the cached one above, another is only loaded when all of them are busy.
+    // At most as many more as the recognition pool has threads are loaded, then the caller waits for one to be given back.
+    std::shared_ptr<const Models> borrow(const std::string& name);
+
 private:
+    Models load_models(const std::string& name);
+    void give_back(const std::string& name, uint64_t generation, const Models* models);
+
     std::shared_ptr<fastdeploy::vision::ocr::DBDetector> load_deter(const std::string& name);
     std::shared_ptr<fastdeploy::vision::ocr::Recognizer> load_recer(const std::string& name);
     std::shared_ptr<fastdeploy::pipeline::PPOCRv3> load_ocrer(const std::string& name);
@@ -50,6 +71,16 @@ private:
     std::unordered_map<std::string, std::shared_ptr<fastdeploy::vision::ocr::DBDetector>> deters_;
     std::unordered_map<std::string, std::shared_ptr<fastdeploy::vision::ocr::Recognizer>> recers_;
     std::unordered_map<std::string, std::shared_ptr<fastdeploy::pipeline::PPOCRv3>> ocrers_;
+
+    std::mutex deters_mutex_;
+    std::mutex recers_mutex_;
+    std::mutex ocrers_mutex_;
+
+    std::unordered_map<std::string, std::vector<Models>> idle_models_;
+    std::unordered_map<std::string, size_t> loaded_models_;
+    uint64_t generation_ = 0; // borrowed models loaded before clear() are not taken back
+    std::mutex models_mutex_;
+    std::condition_variable models_cond_;
 };
 
 MAA_RES_NS_END
@@ -133,12 +133,20 @@ void ONNXResMgr::clear()
 
     classifier_roots_.clear();
     detector_roots_.clear();
-    classifiers_.clear();
-    detectors_.clear();
+    {
+        std::unique_lock lock(classifiers_mutex_);
+        classifiers_.clear();
+    }
+    {
+        std::unique_lock lock(detectors_mutex_);
+        detectors_.clear();
+    }
 }
 
-std::shared_ptr<Ort::Session> ONNXResMgr::classifier(const std::string& name)
+std::shared_ptr<ONNXResMgr::Session> ONNXResMgr::classifier(const std::string& name)
 {
+    std::unique_lock lock(classifiers_mutex_);
+
     if (auto iter = classifiers_.find(name); iter != classifiers_.end()) {
         return iter->second;
     }
@@ -151,8 +159,10 @@ std::shared_ptr<Ort::Session> ONNXResMgr::classifier(const std::string& name)
     return session;
 }
 
-std::shared_ptr<Ort::Session> ONNXResMgr::detector(const std::string& name)
+std::shared_ptr<ONNXResMgr::Session> ONNXResMgr::detector(const std::string& name)
 {
+    std::unique_lock lock(detectors_mutex_);
+
     if (auto iter = detectors_.find(name); iter != detectors_.end()) {
         return iter->second;
     }
@@ -170,7 +180,7 @@ const Ort::MemoryInfo& ONNXResMgr::memory_info() const
     return memory_info_;
 }
 
-std::shared_ptr<Ort::Session> ONNXResMgr::load(const std::string& name, const std::vector<std::filesystem::path>& roots)
+std::shared_ptr<ONNXResMgr::Session> ONNXResMgr::load(const std::string& name, const std::vector<std::filesystem::path>& roots)
 {
     LogFunc << VAR(name) << VAR(roots);
 
@@ -182,7 +192,7 @@ std::shared_ptr<Ort::Session> ONNXResMgr::load(const std::string& name, const st
 
         LogDebug << VAR(path);
         Ort::Session session(env_, path.c_str(), options_);
-        return std::make_shared<Ort::Session>(std::move(session));
+        return std::make_shared<Session>(std::move(session));
     }
 
     return nullptr;
@@ -2,18 +2,22 @@
 
 #include <filesystem>
 #include <memory>
+#include <mutex>
 #include <optional>
 
 #include <onnxruntime/onnxruntime_cxx_api.h>
 
 #include "Conf/Conf.h"
 #include "Utils/NonCopyable.hpp"
+#include "Vision/ONNXSession.h"
 
 MAA_RES_NS_BEGIN
 
 class ONNXResMgr : public NonCopyable
 {
 public:
+    using Session = MAA_VISION_NS::ONNXSession;
+
     inline static const std::filesystem::path kClassifierDir = "classify";
     inline static const std::filesystem::path kDetectorDir = "detect";
 
@@ -29,12 +33,12 @@ public:
     void clear();
 
 public:
-    std::shared_ptr<Ort::Session> classifier(const std::string& name);
-    std::shared_ptr<Ort::Session> detector(const std::string& name);
+    std::shared_ptr<Session> classifier(const std::string& name);
+    std::shared_ptr<Session> detector(const std::string& name);
     const Ort::MemoryInfo& memory_info() const;
 
 private:
-    std::shared_ptr<Ort::Session> load(const std::string& name, const std::vector<std::filesystem::path>& roots);
+    std::shared_ptr<Session> load(const std::string& name, const std::vector<std::filesystem::path>& roots);
 
     std::vector<std::filesystem::path> classifier_roots_;
     std::vector<std::filesystem::path> detector_roots_;
@@ -43,8 +47,11 @@ private:
     Ort::SessionOptions options_;
     Ort::MemoryInfo memory_info_;
 
-    std::unordered_map<std::string, std::shared_ptr<Ort::Session>> classifiers_;
-    std::unordered_map<std::string, std::shared_ptr<Ort::Session>> detectors_;
+    std::unordered_map<std::string, std::shared_ptr<Session>> classifiers_;
+    std::unordered_map<std::string, std::shared_ptr<Session>> detectors_;
+
+    std::mutex classifiers_mutex_;
+    std::mutex detectors_mutex_;
 };
 
 MAA_RES_NS_END
@@ -127,28 +127,9 @@ bool PipelineResMgr::check_all_next_list(const PipelineDataMap& data_map)
 {
     LogFunc;
 
+    auto exists = [&](const std::string& name) { return data_map.contains(name); };
     for (const auto& [name, pipeline_data] : data_map) {
-        if (!check_next_list(pipeline_data.next, data_map)) {
-            LogError << "check_next_list next failed" << VAR(name) << VAR(pipeline_data.next);
-            return false;
-        }
-        if (!check_next_list(pipeline_data.interrupt, data_map)) {
-            LogError << "check_next_list interrupt failed" << VAR(name) << VAR(pipeline_data.interrupt);
-            return false;
-        }
-        if (!check_next_list(pipeline_data.on_error, data_map)) {
-            LogError << "check_next_list on_error failed" << VAR(name) << VAR(pipeline_data.on_error);
-            return false;
-        }
-
-        // 这里是由业务逻辑决定了这三个列表不应有重复元素，不代表以后有其他列表也要直接加进来
-        std::set<std::string> all_next(pipeline_data.next.begin(), pipeline_data.next.end());
-        all_next.insert(pipeline_data.interrupt.begin(), pipeline_data.interrupt.end());
-        all_next.insert(pipeline_data.on_error.begin(), pipeline_data.on_error.end());
-
-        if (all_next.size() != pipeline_data.next.size() + pipeline_data.interrupt.size() + pipeline_data.on_error.size()) {
-            LogError << "there are duplicate elements in the next, interrupt and on_error" << VAR(name) << VAR(pipeline_data.next)
-                     << VAR(pipeline_data.interrupt) << VAR(pipeline_data.on_error);
+        if (!check_node_next_list(name, *pipeline_data, exists)) {
             return false;
         }
     }
@@ -160,24 +141,66 @@ bool PipelineResMgr::check_all_regex(const PipelineDataMap& data_map)
     LogFunc;
 
     for (const auto& [name, pipeline_data] : data_map) {
-        if (pipeline_data.reco_type != Recognition::Type::OCR) {
-            continue;
-        }
-        const auto& reco_param = std::get<MAA_VISION_NS::OCRerParam>(pipeline_data.reco_param);
-        bool valid = std::ranges::all_of(reco_param.expected, regex_valid)
-                     && std::ranges::all_of(reco_param.replace | std::views::keys, regex_valid);
-        if (!valid) {
-            LogError << "regex invalid" << VAR(name);
+        if (!check_node_regex(name, *pipeline_data)) {
             return false;
         }
     }
     return true;
 }
 
-bool PipelineResMgr::check_next_list(const PipelineData::NextList& next_list, const PipelineDataMap& data_map)
+bool PipelineResMgr::check_node_validity(const std::string& name, const PipelineData& pipeline_data, const NodeExists& exists)
+{
+    return check_node_next_list(name, pipeline_data, exists) && check_node_regex(name, pipeline_data);
+}
+
+bool PipelineResMgr::check_node_next_list(const std::string& name, const PipelineData& pipeline_data, const NodeExists& exists)
+{
+    if (!check_next_list(pipeline_data.next, exists)) {
+        LogError << "check_next_list next failed" << VAR(name) << VAR(pipeline_data.next);
+        return false;
+    }
+    if (!check_next_list(pipeline_data.interrupt, exists)) {
+        LogError << "check_next_list interrupt failed" << VAR(name) << VAR(pipeline_data.interrupt);
+        return false;
+    }
+    if (!check_next_list(pipeline_data.on_error, exists)) {
+        LogError << "check_next_list on_error failed" << VAR(name) << VAR(pipeline_data.on_error);
+        return false;
+    }
+
+    // 这里是由业务逻辑决定了这三个列表不应有重复元素，不代表以后有其他列表也要直接加进来
+    std::set<std::string> all_next(pipeline_data.next.begin(), pipeline_data.next.end());
+    all_next.insert(pipeline_data.interrupt.begin(), pipeline_data.interrupt.end());
+    all_next.insert(pipeline_data.on_error.begin(), pipeline_data.on_error.end());
+
+    if (all_next.size() != pipeline_data.next.size() + pipeline_data.interrupt.size() + pipeline_data.on_error.size()) {
+        LogError << "there are duplicate elements in the next, interrupt and on_error" << VAR(name) << VAR(pipeline_data.next)
+                 << VAR(pipeline_data.interrupt) << VAR(pipeline_data.on_error);
+        return false;
+    }
+    return true;
+}
+
+bool PipelineResMgr::check_node_regex(const std::string& name, const PipelineData& pipeline_data)
+{
+    if (pipeline_data.reco_type != Recognition::Type::OCR) {
+        return true;
+    }
+    const auto& reco_param = std::get<MAA_VISION_NS::OCRerParam>(pipeline_data.reco_param);
+    // the patterns are compiled by parse_ocrer_param, which fails on an invalid one
+    bool valid =
+        reco_param.expected_regex.size() == reco_param.expected.size() && reco_param.replace_regex.size() == reco_param.replace.size();
+    if (!valid) {
+        LogError << "regex invalid" << VAR(name);
+        return false;
+    }
+    return true;
+}
+
+bool PipelineResMgr::check_next_list(const PipelineData::NextList& next_list, const NodeExists& exists)
 {
     for (const auto& next : next_list) {
-        if (!data_map.contains(next)) {
+        if (!exists(next)) {
             LogError << "Invalid next node name" << VAR(next);
             return false;
         }
@@ -217,7 +240,8 @@ bool PipelineResMgr::parse_config(const json::value& input, std::set<std::string
         }
 
         PipelineData result;
-        const auto& default_result = pipeline_data_map_.contains(key) ? pipeline_data_map_.at(key) : default_mgr.get_pipeline();
+        auto default_it = pipeline_data_map_.find(key);
+        const auto& default_result = default_it != pipeline_data_map_.end() ? *default_it->second : default_mgr.get_pipeline();
         bool ret = parse_task(key, value, result, default_result, default_mgr);
         if (!ret) {
             LogError << "parse_task failed" << VAR(key) << VAR(value);
@@ -225,7 +249,7 @@ bool PipelineResMgr::parse_config(const json::value& input, std::set<std::string
         }
 
         existing_keys.emplace(key);
-        pipeline_data_map_.insert_or_assign(key, std::move(result));
+        pipeline_data_map_.insert_or_assign(key, std::make_shared<PipelineData>(std::move(result)));
     }
 
     return true;
@@ -363,6 +387,11 @@ bool PipelineResMgr::parse_task(
         }
     }
 
+    if (!get_and_check_value(input, "parallel_recognition", data.parallel_recognition, default_value.parallel_recognition)) {
+        LogError << "failed to get_and_check_value parallel_recognition" << VAR(input);
+        return false;
+    }
+
     auto rate_limit = default_value.rate_limit.count();
     if (!get_and_check_value(input, "rate_limit", rate_limit, rate_limit)) {
         LogError << "failed to get_and_check_value rate_limit" << VAR(input);
@@ -377,6 +406,15 @@ bool PipelineResMgr::parse_task(
     }
     data.reco_timeout = std::chrono::milliseconds(timeout);
 
+    if (!get_and_check_value(input, "frame_diff_threshold", data.frame_diff_threshold, default_value.frame_diff_threshold)) {
+        LogError << "failed to get_and_check_value frame_diff_threshold" << VAR(input);
+        return false;
+    }
+    if (data.frame_diff_threshold < 0 || data.frame_diff_threshold > 255) {
+        LogError << "frame_diff_threshold must be in [0, 255]" << VAR(data.frame_diff_threshold);
+        return false;
+    }
+
     auto pre_delay = default_value.pre_delay.count();
     if (!get_and_check_value(input, "pre_delay", pre_delay, pre_delay)) {
         LogError << "failed to get_and_check_value pre_delay" << VAR(input);
@@ -594,6 +632,15 @@ bool PipelineResMgr::parse_template_matcher_param(
         return false;
     }
 
+    if (!get_and_check_value(input, "pyramid_level", output.pyramid_level, default_value.pyramid_level)) {
+        LogError << "failed to get_and_check_value pyramid_level" << VAR(input);
+        return false;
+    }
+    if (output.pyramid_level < 0) {
+        LogError << "pyramid_level must be non-negative" << VAR(output.pyramid_level);
+        return false;
+    }
+
     return true;
 }
 
@@ -773,6 +820,23 @@ bool PipelineResMgr::parse_ocrer_param(
         output.replace = default_value.replace;
     }
 
+    try {
+        output.expected_regex.clear();
+        for (const auto& pattern : output.expected) {
+            output.expected_regex.emplace_back(
+                MAA_VISION_NS::OCRerParam::is_literal(pattern) ? nullptr : std::make_shared<const std::wregex>(pattern));
+        }
+        output.replace_regex.clear();
+        for (const auto& rep : output.replace) {
+            output.replace_regex.emplace_back(
+                MAA_VISION_NS::OCRerParam::is_literal_replace(rep) ? nullptr : std::make_shared<const std::wregex>(rep.first));
+        }
+    }
+    catch (const std::regex_error& e) {
+        LogError << "failed to compile regex" << VAR(e.what()) << VAR(input);
+        return false;
+    }
+
     return true;
 }
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <filesystem>
+#include <functional>
 #include <set>
 #include <unordered_map>
 #include <unordered_set>
@@ -17,7 +18,7 @@ MAA_RES_NS_BEGIN
 class PipelineResMgr : public NonCopyable
 {
 public:
-    using PipelineDataMap = std::unordered_map<std::string, PipelineData>;
+    using PipelineDataMap = std::unordered_map<std::string, PipelineDataPtr>;
 
 public:
     bool load(const std::filesystem::path& path, bool is_base, const DefaultPipelineMgr& default_mgr);
@@ -118,13 +119,20 @@ public:
     static bool check_all_next_list(const PipelineDataMap& data_map);
     static bool check_all_regex(const PipelineDataMap& data_map);
 
+    using NodeExists = std::function<bool(const std::string&)>;
+    // checks a single node, the nodes it points to are looked up with `exists`.
+    // enough to validate nodes added to an already valid map, as long as nothing is removed from it
+    static bool check_node_validity(const std::string& name, const PipelineData& pipeline_data, const NodeExists& exists);
+
 private:
     bool load_all_json(const std::filesystem::path& path, const DefaultPipelineMgr& default_mgr);
     bool
         open_and_parse_file(const std::filesystem::path& path, std::set<std::string>& existing_keys, const DefaultPipelineMgr& default_mgr);
     bool parse_config(const json::value& input, std::set<std::string>& existing_keys, const DefaultPipelineMgr& default_mg);
 
-    static bool check_next_list(const PipelineData::NextList& next_list, const PipelineDataMap& data_map);
+    static bool check_node_next_list(const std::string& name, const PipelineData& pipeline_data, const NodeExists& exists);
+    static bool check_node_regex(const std::string& name, const PipelineData& pipeline_data);
+    static bool check_next_list(const PipelineData::NextList& next_list, const NodeExists& exists);
 
 private:
     std::vector<std::filesystem::path> paths_;
@@ -144,8 +144,11 @@ struct PipelineData
     NextList next;
     NextList interrupt;
     NextList on_error;
+    bool parallel_recognition = false; // recognize next + interrupt concurrently, the first hit in list order still wins
     std::chrono::milliseconds rate_limit = std::chrono::milliseconds(1000);
     std::chrono::milliseconds reco_timeout = std::chrono::milliseconds(20 * 1000);
+    // 0 disables, otherwise a screenshot whose downsampled gray pixels all differ by less than it skips the recognition
+    int frame_diff_threshold = 0;
 
     std::chrono::milliseconds pre_delay = std::chrono::milliseconds(200);
     std::chrono::milliseconds post_delay = std::chrono::milliseconds(200);
@@ -156,4 +159,7 @@ struct PipelineData
     json::value focus;
 };
 
+// nodes are never modified once parsed. they are shared by the resource, the overrides of every context and the running tasks.
+using PipelineDataPtr = std::shared_ptr<const PipelineData>;
+
 MAA_RES_NS_END
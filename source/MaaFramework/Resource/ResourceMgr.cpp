@@ -55,6 +55,7 @@ MaaResId ResourceMgr::post_bundle(const std::filesystem::path& path)
 
     valid_ = false;
     hash_cache_.clear();
+    ++generation_;
 
     if (!res_loader_) {
         LogError << "res_loader_ is nullptr";
@@ -168,6 +169,7 @@ bool ResourceMgr::clear()
     template_res_.clear();
     paths_.clear();
     hash_cache_.clear();
+    ++generation_;
 
     valid_ = true;
 
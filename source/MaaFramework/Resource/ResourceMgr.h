@@ -56,6 +56,8 @@ public: // MaaResource
 public:
     void post_stop();
     std::string calc_hash();
+    // changes whenever a bundle is posted or the resource is cleared, results cached for the previous models are stale
+    uint64_t generation() const { return generation_; }
 
     const auto& pipeline_res() const { return pipeline_res_; }
 
@@ -114,6 +116,7 @@ private:
     std::vector<std::filesystem::path> paths_;
     mutable std::string hash_cache_;
     std::atomic_bool valid_ = true;
+    std::atomic_uint64_t generation_ = 0;
 
     std::unique_ptr<AsyncRunner<std::filesystem::path>> res_loader_ = nullptr;
     MessageNotifier notifier_;
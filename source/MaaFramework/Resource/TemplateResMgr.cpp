@@ -22,11 +22,21 @@ void TemplateResMgr::clear()
     LogFunc;
 
     roots_.clear();
-    images_.clear();
+
+    {
+        std::unique_lock lock(images_mutex_);
+        images_.clear();
+    }
+    {
+        std::unique_lock lock(features_mutex_);
+        features_.clear();
+    }
 }
 
 std::shared_ptr<TemplateResMgr::Image> TemplateResMgr::image(const std::string& name)
 {
+    std::unique_lock lock(images_mutex_);
+
     if (auto iter = images_.find(name); iter != images_.end()) {
         return iter->second;
     }
@@ -39,6 +49,24 @@ std::shared_ptr<TemplateResMgr::Image> TemplateResMgr::image(const std::string&
     return img;
 }
 
+std::shared_ptr<const TemplateResMgr::Features> TemplateResMgr::features(const std::string& name, Detector detector, bool green_mask)
+{
+    std::unique_lock lock(features_mutex_);
+
+    auto iter = features_.find(FeaturesKey(name, detector, green_mask));
+    return iter == features_.end() ? nullptr : iter->second;
+}
+
+void TemplateResMgr::set_features(const std::string& name, Detector detector, bool green_mask, std::shared_ptr<const Features> features)
+{
+    if (!features) {
+        return;
+    }
+
+    std::unique_lock lock(features_mutex_);
+    features_.insert_or_assign(FeaturesKey(name, detector, green_mask), std::move(features));
+}
+
 std::shared_ptr<TemplateResMgr::Image> TemplateResMgr::load(const std::string& name)
 {
     LogFunc << VAR(name) << VAR(roots_);
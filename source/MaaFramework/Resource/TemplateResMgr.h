@@ -2,10 +2,13 @@
 
 #include <filesystem>
 #include <map>
+#include <mutex>
+#include <tuple>
 
 #include "Conf/Conf.h"
 #include "Utils/NoWarningCVMat.hpp"
 #include "Utils/NonCopyable.hpp"
+#include "Vision/VisionTypes.h"
 
 MAA_RES_NS_BEGIN
 
@@ -13,6 +16,8 @@ class TemplateResMgr : public NonCopyable
 {
 public:
     using Image = cv::Mat;
+    using Features = MAA_VISION_NS::TemplateFeatures;
+    using Detector = MAA_VISION_NS::FeatureMatcherParam::Detector;
 
     bool lazy_load(const std::filesystem::path& path, bool is_base);
 
@@ -21,12 +26,21 @@ public:
 public:
     std::shared_ptr<Image> image(const std::string& name);
 
+    // features and trained matcher of the template image, prepared by FeatureMatcher and stored back by the caller
+    std::shared_ptr<const Features> features(const std::string& name, Detector detector, bool green_mask);
+    void set_features(const std::string& name, Detector detector, bool green_mask, std::shared_ptr<const Features> features);
+
 private:
     std::shared_ptr<Image> load(const std::string& name);
 
     std::vector<std::filesystem::path> roots_;
 
     std::map<std::string, std::shared_ptr<Image>> images_;
+    std::mutex images_mutex_;
+
+    using FeaturesKey = std::tuple<std::string, Detector, bool>;
+    std::map<FeaturesKey, std::shared_ptr<const Features>> features_;
+    std::mutex features_mutex_;
 };
 
 MAA_RES_NS_END
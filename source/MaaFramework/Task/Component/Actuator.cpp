@@ -4,7 +4,7 @@
 #include "Controller/ControllerAgent.h"
 #include "CustomAction.h"
 #include "Utils/Logger.h"
-#include "Vision/TemplateComparator.h"
+#include "Vision/FreezeDetector.h"
 
 MAA_TASK_NS_BEGIN
 
@@ -170,6 +170,7 @@ void Actuator::wait_freezes(const MAA_RES_NS::WaitFreezesParam& param, const cv:
         .threshold = param.threshold,
         .method = param.method,
     };
+    FreezeDetector detector(pre_image, roi, comp_param);
 
     const auto start_clock = std::chrono::steady_clock::now();
     auto pre_image_clock = start_clock;
@@ -191,9 +192,7 @@ void Actuator::wait_freezes(const MAA_RES_NS::WaitFreezesParam& param, const cv:
             break;
         }
 
-        TemplateComparator comparator(pre_image, cur_image, roi, comp_param);
-
-        if (!comparator.best_result()) {
+        if (!detector.update(cur_image)) {
             pre_image = cur_image;
             pre_image_clock = std::chrono::steady_clock::now();
             continue;
@@ -37,7 +37,8 @@ void CustomRecognition::analyze()
     auto start_time = std::chrono::steady_clock::now();
 
     /*in*/
-    ImageBuffer image_buffer(image_);
+    // the screenshot is shared with later nodes and the runtime cache, while the callback gets a writable pointer
+    ImageBuffer image_buffer(image_.clone());
     MaaRect rect_buf { .x = roi_.x, .y = roi_.y, .width = roi_.width, .height = roi_.height };
     std::string custom_param_str = param_.custom_param.to_string();
 
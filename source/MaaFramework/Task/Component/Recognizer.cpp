@@ -22,6 +22,11 @@ Recognizer::Recognizer(Tasker* tasker, Context& context, const cv::Mat& image_)
 {
 }
 
+void Recognizer::set_batch_candidates(std::vector<MAA_RES_NS::PipelineDataPtr> candidates)
+{
+    batch_candidates_ = std::move(candidates);
+}
+
 RecoResult Recognizer::recognize(const PipelineData& pipeline_data)
 {
     if (!tasker_) {
@@ -80,16 +85,23 @@ RecoResult Recognizer::recognize(const PipelineData& pipeline_data)
         result.box = result.box ? std::nullopt : std::make_optional<cv::Rect>();
     }
 
+    if (!deferred_) {
+        commit(pipeline_data.name, result);
+    }
+
+    return result;
+}
+
+void Recognizer::commit(const std::string& node_name, const RecoResult& result) const
+{
     tasker_->runtime_cache().set_reco_detail(result.reco_id, result);
 
-    save_draws(pipeline_data.name, result);
+    save_draws(node_name, result);
 
     if (result.box) {
         const auto& box = *result.box;
-        show_hit_draw(box, pipeline_data.name, result.reco_id);
+        show_hit_draw(box, node_name, result.reco_id);
     }
-
-    return result;
 }
 
 template <typename Res>
@@ -157,17 +169,30 @@ RecoResult Recognizer::feature_match(const MAA_VISION_NS::FeatureMatcherParam& p
 
     cv::Rect roi = get_roi(param.roi_target);
 
+    auto& template_res = resource()->template_res();
+
+    std::vector<std::string> paths;
     std::vector<std::shared_ptr<cv::Mat>> templates;
+    std::vector<std::shared_ptr<const FeatureMatcher::Template>> template_features;
     for (const auto& path : param.template_paths) {
-        auto templ = resource()->template_res().image(path);
+        auto templ = template_res.image(path);
         if (!templ) {
             LogWarn << "Template not found:" << path;
             continue;
         }
+        paths.emplace_back(path);
         templates.emplace_back(std::move(templ));
+        template_features.emplace_back(template_res.features(path, param.detector, param.green_mask));
     }
 
-    FeatureMatcher analyzer(image_, roi, param, templates, name);
+    FeatureMatcher analyzer(image_, roi, param, templates, template_features, feature_scene_cache_, name);
+
+    // store the templates prepared in this run, so they are neither detected nor trained again
+    for (size_t i = 0; i != paths.size(); ++i) {
+        if (!template_features.at(i)) {
+            template_res.set_features(paths.at(i), param.detector, param.green_mask, analyzer.template_features().at(i));
+        }
+    }
 
     std::optional<cv::Rect> box = std::nullopt;
     if (analyzer.best_result()) {
@@ -219,11 +244,18 @@ RecoResult Recognizer::ocr(const MAA_VISION_NS::OCRerParam& param, const std::st
 
     cv::Rect roi = get_roi(param.roi_target);
 
-    auto det_session = resource()->ocr_res().deter(param.model);
-    auto reco_session = resource()->ocr_res().recer(param.model);
-    auto ocr_session = resource()->ocr_res().ocrer(param.model);
+    // held until the analyzer is done, no other recognition runs inference on these instances meanwhile
+    auto models = resource()->ocr_res().borrow(param.model);
 
-    OCRer analyzer(image_, roi, param, det_session, reco_session, ocr_session, ocr_cache_, name);
+    if (param.only_rec && batched_recers_.emplace(param.model).second) {
+        auto rois = batch_rois([&](const PipelineData& data) -> const Target* {
+            const auto* p = std::get_if<OCRerParam>(&data.reco_param);
+            return p && p->only_rec && p->model == param.model ? &p->roi_target : nullptr;
+        });
+        OCRer::batch_only_rec(image_, rois, param.model, models->recer, ocr_caches_[{ param.model, true }], &tasker_->ocr_cache());
+    }
+    auto& cache = ocr_caches_[{ param.model, param.only_rec }];
+    OCRer analyzer(image_, roi, param, models->deter, models->recer, models->ocrer, cache, &tasker_->ocr_cache(), name);
 
     std::optional<cv::Rect> box = std::nullopt;
     if (analyzer.best_result()) {
@@ -252,8 +284,17 @@ RecoResult Recognizer::nn_classify(const MAA_VISION_NS::NeuralNetworkClassifierP
     auto& onnx_res = resource()->onnx_res();
     const auto& session = onnx_res.classifier(param.model);
     const auto& mem_info = onnx_res.memory_info();
+    auto& cache = classifier_caches_[param.model];
+
+    if (session && batched_classifiers_.emplace(param.model).second) {
+        auto rois = batch_rois([&](const PipelineData& data) -> const Target* {
+            const auto* p = std::get_if<NeuralNetworkClassifierParam>(&data.reco_param);
+            return p && p->model == param.model ? &p->roi_target : nullptr;
+        });
+        NeuralNetworkClassifier::batch_infer(image_, rois, *session, mem_info, cache);
+    }
 
-    NeuralNetworkClassifier analyzer(image_, roi, param, session, mem_info, name);
+    NeuralNetworkClassifier analyzer(image_, roi, param, session, mem_info, cache, name);
 
     std::optional<cv::Rect> box = std::nullopt;
     if (analyzer.best_result()) {
@@ -366,6 +407,17 @@ cv::Rect Recognizer::get_roi(const MAA_VISION_NS::Target& roi)
     return cv::Rect { raw.x + roi.offset.x, raw.y + roi.offset.y, raw.width + roi.offset.width, raw.height + roi.offset.height };
 }
 
+std::vector<cv::Rect> Recognizer::batch_rois(const std::function<const MAA_VISION_NS::Target*(const PipelineData&)>& target_of)
+{
+    std::vector<cv::Rect> rois;
+    for (const auto& data : batch_candidates_) {
+        if (const auto* target = target_of(*data)) {
+            rois.emplace_back(get_roi(*target));
+        }
+    }
+    return rois;
+}
+
 void Recognizer::save_draws(const std::string& node_name, const RecoResult& result) const
 {
     const auto& option = GlobalOptionMgr::get_instance();
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <functional>
+#include <map>
+#include <set>
+
 #include <meojson/json.hpp>
 
 #include "Common/MaaTypes.h"
@@ -7,6 +11,8 @@
 #include "Resource/PipelineTypes.h"
 #include "Task/Context.h"
 #include "Tasker/Tasker.h"
+#include "Vision/FeatureMatcher.h"
+#include "Vision/NeuralNetworkClassifier.h"
 #include "Vision/OCRer.h"
 
 MAA_TASK_NS_BEGIN
@@ -16,6 +22,8 @@ class Recognizer
 public:
     using PipelineData = MAA_RES_NS::PipelineData;
     using OcrCache = MAA_VISION_NS::OCRer::Cache;
+    using FeatureSceneCache = MAA_VISION_NS::FeatureMatcher::SceneCache;
+    using ClassifierCache = MAA_VISION_NS::NeuralNetworkClassifier::Cache;
 
 public:
     explicit Recognizer(Tasker* tasker, Context& context, const cv::Mat& image);
@@ -23,6 +31,15 @@ public:
 public:
     RecoResult recognize(const PipelineData& pipeline_data);
 
+    // nodes that may be recognized later on this image. same-model classifier and only_rec OCR nodes among them are
+    // inferred as one batch when the first of them is recognized.
+    void set_batch_candidates(std::vector<MAA_RES_NS::PipelineDataPtr> candidates);
+
+    // recognitions on the pool leave the reco detail, the saved draws and the hit draw to the task thread, which only commits
+    // the result it consumes. HighGUI windows only work on one thread as well.
+    void set_deferred(bool deferred) { deferred_ = deferred; }
+    void commit(const std::string& node_name, const RecoResult& result) const;
+
 private:
     RecoResult direct_hit(const std::string& name);
     RecoResult template_match(const MAA_VISION_NS::TemplateMatcherParam& param, const std::string& name);
@@ -34,6 +51,7 @@ private:
     RecoResult custom_recognize(const MAA_VISION_NS::CustomRecognitionParam& param, const std::string& name);
 
     cv::Rect get_roi(const MAA_VISION_NS::Target& roi);
+    std::vector<cv::Rect> batch_rois(const std::function<const MAA_VISION_NS::Target*(const PipelineData&)>& target_of);
     void save_draws(const std::string& node_name, const RecoResult& result) const;
     void show_hit_draw(const cv::Rect& box, const std::string& node_name, MaaRecoId uid) const;
 
@@ -45,8 +63,16 @@ private:
     Tasker* tasker_ = nullptr;
     Context& context_;
     cv::Mat image_;
+    bool deferred_ = false;
+
+    // a det+rec result is not an only_rec one, nor is one of another model, even on the same roi
+    std::map<std::pair<std::string, bool>, OcrCache> ocr_caches_;
+    FeatureSceneCache feature_scene_cache_;
+    std::map<std::string, ClassifierCache> classifier_caches_;
 
-    OcrCache ocr_cache_;
+    std::vector<MAA_RES_NS::PipelineDataPtr> batch_candidates_;
+    std::set<std::string> batched_classifiers_;
+    std::set<std::string> batched_recers_;
 };
 
 MAA_TASK_NS_END
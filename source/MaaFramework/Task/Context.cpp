@@ -125,36 +125,52 @@ bool Context::override_pipeline(const json::object& pipeline_override)
     }
     auto& default_mgr = resource->default_pipeline();
 
+    // nothing is applied unless all of it is valid, so that pipeline_override_ stays valid
+    PipelineDataMap overridden;
     for (const auto& [key, value] : pipeline_override) {
         PipelineData result;
-        auto default_result = get_pipeline_data(key).value_or(default_mgr.get_pipeline());
+        auto default_ptr = get_pipeline_data(key);
+        const auto& default_result = default_ptr ? *default_ptr : default_mgr.get_pipeline();
         bool ret = MAA_RES_NS::PipelineResMgr::parse_task(key, value, result, default_result, default_mgr);
         if (!ret) {
             LogError << "parse_task failed" << VAR(key) << VAR(value);
             return false;
         }
 
-        pipeline_override_.insert_or_assign(key, std::move(result));
+        overridden.insert_or_assign(key, std::make_shared<PipelineData>(std::move(result)));
     }
 
-    return check_pipeline();
+    if (!check_pipeline(overridden)) {
+        return false;
+    }
+
+    apply_override(std::move(overridden));
+    return true;
 }
 
 bool Context::override_next(const std::string& name, const std::vector<std::string>& next)
 {
     LogFunc << VAR(getptr()) << VAR(name) << VAR(next);
 
-    auto data_opt = get_pipeline_data(name);
-    if (!data_opt) {
+    auto data_ptr = get_pipeline_data(name);
+    if (!data_ptr) {
         LogError << "get_pipeline_data failed, task not exist" << VAR(name);
         return false;
     }
 
-    data_opt->next = next;
+    // the node may be shared, so it is copied before being modified
+    auto data = std::make_shared<PipelineData>(*data_ptr);
+    data->next = next;
 
-    pipeline_override_.insert_or_assign(name, std::move(*data_opt));
+    PipelineDataMap overridden;
+    overridden.emplace(name, std::move(data));
+
+    if (!check_pipeline(overridden)) {
+        return false;
+    }
 
-    return check_pipeline();
+    apply_override(std::move(overridden));
+    return true;
 }
 
 Context* Context::clone() const
@@ -178,7 +194,7 @@ Tasker* Context::tasker() const
     return tasker_;
 }
 
-std::optional<Context::PipelineData> Context::get_pipeline_data(const std::string& node_name)
+Context::PipelineDataPtr Context::get_pipeline_data(const std::string& node_name)
 {
     auto override_it = pipeline_override_.find(node_name);
     if (override_it != pipeline_override_.end()) {
@@ -188,12 +204,12 @@ std::optional<Context::PipelineData> Context::get_pipeline_data(const std::strin
 
     if (!tasker_) {
         LogError << "tasker is null";
-        return std::nullopt;
+        return nullptr;
     }
     auto* resource = tasker_->resource();
     if (!resource) {
         LogError << "resource not bound";
-        return std::nullopt;
+        return nullptr;
     }
 
     auto& raw_data_map = resource->pipeline_res().get_pipeline_data_map();
@@ -203,7 +219,7 @@ std::optional<Context::PipelineData> Context::get_pipeline_data(const std::strin
     }
 
     LogWarn << "task not found" << VAR(node_name);
-    return std::nullopt;
+    return nullptr;
 }
 
 bool& Context::need_to_stop()
@@ -211,7 +227,7 @@ bool& Context::need_to_stop()
     return need_to_stop_;
 }
 
-bool Context::check_pipeline() const
+bool Context::check_pipeline(const PipelineDataMap& overridden) const
 {
     if (!tasker_) {
         LogError << "tasker is null";
@@ -223,11 +239,25 @@ bool Context::check_pipeline() const
         return false;
     }
 
-    auto raw = resource->pipeline_res().get_pipeline_data_map();
-    auto all = pipeline_override_;
-    all.merge(raw);
+    const auto& raw = resource->pipeline_res().get_pipeline_data_map();
+    auto exists = [&](const std::string& name) {
+        return overridden.contains(name) || pipeline_override_.contains(name) || raw.contains(name);
+    };
 
-    return MAA_RES_NS::PipelineResMgr::check_all_validity(all);
+    for (const auto& [name, pipeline_data] : overridden) {
+        if (!MAA_RES_NS::PipelineResMgr::check_node_validity(name, *pipeline_data, exists)) {
+            LogError << "check_node_validity failed" << VAR(name);
+            return false;
+        }
+    }
+    return true;
+}
+
+void Context::apply_override(PipelineDataMap overridden)
+{
+    // merge keeps the new nodes, and moves over only the old ones that are not replaced
+    overridden.merge(pipeline_override_);
+    pipeline_override_ = std::move(overridden);
 }
 
 MAA_TASK_NS_END
@@ -21,6 +21,7 @@ private:
 
 public:
     using PipelineData = MAA_RES_NS::PipelineData;
+    using PipelineDataPtr = MAA_RES_NS::PipelineDataPtr;
     using PipelineDataMap = MAA_RES_NS::PipelineResMgr::PipelineDataMap;
 
 public:
@@ -49,15 +50,19 @@ public: // from MaaContextAPI
     virtual Tasker* tasker() const override;
 
 public:
-    std::optional<PipelineData> get_pipeline_data(const std::string& node_name);
+    // nullptr if not found. shared rather than copied, since it is looked up several times for every step.
+    PipelineDataPtr get_pipeline_data(const std::string& node_name);
     bool& need_to_stop();
 
 private:
-    bool check_pipeline() const;
+    // only `overridden` is checked, the nodes already there were valid and overriding never removes any
+    bool check_pipeline(const PipelineDataMap& overridden) const;
+    void apply_override(PipelineDataMap overridden);
 
     MaaTaskId task_id_ = 0;
     Tasker* tasker_ = nullptr;
 
+    // copied by clone(), which shares the nodes themselves
     PipelineDataMap pipeline_override_;
 
 private:
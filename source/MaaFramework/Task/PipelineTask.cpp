@@ -9,6 +9,7 @@
 #include "Tasker/Tasker.h"
 #include "Utils/JsonExt.hpp"
 #include "Utils/Logger.h"
+#include "Utils/NoWarningCV.hpp"
 
 MAA_TASK_NS_BEGIN
 
@@ -24,28 +25,27 @@ bool PipelineTask::run()
     std::stack<std::string> task_stack;
 
     // there is no pretask for the entry, so we use the entry itself
-    auto begin_opt = context_->get_pipeline_data(entry_);
-    if (!begin_opt) {
+    PipelineDataPtr node = context_->get_pipeline_data(entry_);
+    if (!node) {
         LogError << "get_pipeline_data failed, task not exist" << VAR(entry_);
         return false;
     }
 
-    PipelineData node = std::move(*begin_opt);
     PipelineData::NextList next = { entry_ };
     PipelineData::NextList interrupt;
     bool error_handling = false;
 
     while (!next.empty() && !context_->need_to_stop()) {
-        cur_node_ = node.name;
+        cur_node_ = node->name;
 
         size_t next_size = next.size();
         PipelineData::NextList list = std::move(next);
         list.insert(list.end(), std::make_move_iterator(interrupt.begin()), std::make_move_iterator(interrupt.end()));
 
-        auto node_detail = run_reco_and_action(list, node);
+        auto node_detail = run_reco_and_action(list, *node);
 
         if (context_->need_to_stop()) {
-            LogWarn << "need_to_stop" << VAR(node.name);
+            LogWarn << "need_to_stop" << VAR(node->name);
             return true;
         }
 
@@ -56,31 +56,30 @@ bool PipelineTask::run()
             // 且 PipelineResMgr::check_all_next_list 保证了 next + interrupt 中没有同名任务
             auto pos = std::ranges::find(list, node_detail.name) - list.begin();
             bool is_interrupt = static_cast<size_t>(pos) >= next_size;
-            auto hit_opt = context_->get_pipeline_data(node_detail.name);
-            if (!hit_opt) {
+            PipelineDataPtr hit_node = context_->get_pipeline_data(node_detail.name);
+            if (!hit_node) {
                 LogError << "get_pipeline_data failed, task not exist" << VAR(node_detail.name);
                 return false;
             }
-            PipelineData hit_node = std::move(*hit_opt);
 
-            if (is_interrupt || hit_node.is_sub) { // for compatibility with v1.x
-                LogInfo << "push task_stack:" << node.name;
-                task_stack.emplace(node.name);
+            if (is_interrupt || hit_node->is_sub) { // for compatibility with v1.x
+                LogInfo << "push task_stack:" << node->name;
+                task_stack.emplace(node->name);
             }
 
-            node = hit_node;
-            next = hit_node.next;
-            interrupt = hit_node.interrupt;
+            node = std::move(hit_node);
+            next = node->next;
+            interrupt = node->interrupt;
         }
         else if (error_handling) {
-            LogError << "error handling loop detected" << VAR(node.name);
+            LogError << "error handling loop detected" << VAR(node->name);
             next.clear();
             interrupt.clear();
         }
         else {
-            LogInfo << "handle error" << VAR(node.name);
+            LogInfo << "handle error" << VAR(node->name);
             error_handling = true;
-            next = node.on_error;
+            next = node->on_error;
             interrupt.clear();
         }
 
@@ -89,14 +88,13 @@ bool PipelineTask::run()
             LogInfo << "pop task_stack:" << top;
             task_stack.pop();
 
-            auto top_opt = context_->get_pipeline_data(top);
-            if (!top_opt) {
+            node = context_->get_pipeline_data(top);
+            if (!node) {
                 LogError << "get_pipeline_data failed, task not exist" << VAR(top);
                 return false;
             }
-            node = std::move(*top_opt);
-            next = node.next;
-            interrupt = node.interrupt;
+            next = node->next;
+            interrupt = node->interrupt;
         }
     }
 
@@ -128,13 +126,25 @@ NodeDetail PipelineTask::run_reco_and_action(const PipelineData::NextList& list,
     const auto start_clock = std::chrono::steady_clock::now();
     std::chrono::steady_clock::time_point current_clock;
 
+    const bool diff_gating = pretask.frame_diff_threshold > 0;
+    // of the last screenshot recognized without any hit
+    cv::Mat last_thumbnail;
+
     while (true) {
         current_clock = std::chrono::steady_clock::now();
         cv::Mat image = screencap();
 
-        reco = run_recognition(image, list);
-        if (reco.box) { // hit
-            break;
+        cv::Mat thumbnail = diff_gating ? make_thumbnail(image) : cv::Mat();
+        if (diff_gating && !frame_changed(last_thumbnail, thumbnail, pretask.frame_diff_threshold)) {
+            // the same list on the same screen would miss again
+            LogDebug << "frame unchanged, skip recognition" << VAR(pretask.name);
+        }
+        else {
+            reco = run_recognition(image, list);
+            if (reco.box) { // hit
+                break;
+            }
+            last_thumbnail = std::move(thumbnail);
         }
 
         if (context_->need_to_stop()) {
@@ -155,4 +165,35 @@ NodeDetail PipelineTask::run_reco_and_action(const PipelineData::NextList& list,
     return node_detail;
 }
 
+cv::Mat PipelineTask::make_thumbnail(const cv::Mat& image)
+{
+    if (image.empty()) {
+        return {};
+    }
+
+    // area averaging smooths out noise, while a local change still shows up in its block
+    constexpr double kScale = 1.0 / 8;
+
+    cv::Mat small;
+    cv::resize(image, small, cv::Size(), kScale, kScale, cv::INTER_AREA);
+
+    cv::Mat gray;
+    cv::cvtColor(small, gray, cv::COLOR_BGR2GRAY);
+    return gray;
+}
+
+bool PipelineTask::frame_changed(const cv::Mat& last_thumbnail, const cv::Mat& thumbnail, int threshold)
+{
+    if (last_thumbnail.empty() || thumbnail.empty() || last_thumbnail.size() != thumbnail.size()) {
+        return true;
+    }
+
+    cv::Mat diff;
+    cv::absdiff(last_thumbnail, thumbnail, diff);
+
+    double max_diff = 0;
+    cv::minMaxLoc(diff, nullptr, &max_diff);
+    return max_diff >= threshold;
+}
+
 MAA_TASK_NS_END
@@ -19,6 +19,9 @@ public:
 
 private:
     NodeDetail run_reco_and_action(const PipelineData::NextList& list, const PipelineData& pretask);
+
+    static cv::Mat make_thumbnail(const cv::Mat& image);
+    static bool frame_changed(const cv::Mat& last_thumbnail, const cv::Mat& thumbnail, int threshold);
 };
 
 MAA_TASK_NS_END
@@ -1,5 +1,7 @@
 #include "TaskBase.h"
 
+#include <future>
+
 #include "Component/Actuator.h"
 #include "Component/Recognizer.h"
 #include "Controller/ControllerAgent.h"
@@ -71,8 +73,8 @@ RecoResult TaskBase::run_recognition(const cv::Mat& image, const PipelineData::N
         return {};
     }
 
-    auto node_opt = context_->get_pipeline_data(cur_node_);
-    if (!node_opt) {
+    auto node_ptr = context_->get_pipeline_data(cur_node_);
+    if (!node_ptr) {
         LogError << "get_pipeline_data failed, node not exist" << VAR(cur_node_);
         return {};
     }
@@ -81,64 +83,164 @@ RecoResult TaskBase::run_recognition(const cv::Mat& image, const PipelineData::N
         { "task_id", task_id() },
         { "name", cur_node_ },
         { "list", json::array(list) },
-        { "focus", node_opt->focus },
+        { "focus", node_ptr->focus },
     };
-    if (debug_mode() || !node_opt->focus.is_null()) {
+    if (debug_mode() || !node_ptr->focus.is_null()) {
         notify(MaaMsg_Node_NextList_Starting, reco_list_cb_detail);
     }
 
+    RecoResult result = node_ptr->parallel_recognition ? recognize_list_parallel(image, list) : recognize_list(image, list);
+
+    if (debug_mode() || !node_ptr->focus.is_null()) {
+        notify(result.box ? MaaMsg_Node_NextList_Succeeded : MaaMsg_Node_NextList_Failed, reco_list_cb_detail);
+    }
+
+    return result;
+}
+
+RecoResult TaskBase::recognize_list(const cv::Mat& image, const PipelineData::NextList& list)
+{
     Recognizer recognizer(tasker_, *context_, image);
 
+    // a snapshot for batching only. the nodes are still looked up one by one below,
+    // since a custom recognition may override the ones after it.
+    std::vector<PipelineDataPtr> batch_candidates;
+    for (const auto& node : list) {
+        if (auto data_ptr = context_->get_pipeline_data(node); data_ptr && data_ptr->enable) {
+            batch_candidates.emplace_back(std::move(data_ptr));
+        }
+    }
+    recognizer.set_batch_candidates(std::move(batch_candidates));
+
     for (const auto& node : list) {
-        auto data_opt = context_->get_pipeline_data(node);
-        if (!data_opt) {
+        auto data_ptr = context_->get_pipeline_data(node);
+        if (!data_ptr) {
             LogError << "get_pipeline_data failed, node not exist" << VAR(node);
             continue;
         }
-        const auto& pipeline_data = *data_opt;
+        const auto& pipeline_data = *data_ptr;
 
         if (!pipeline_data.enable) {
             LogDebug << "node disabled" << node << VAR(pipeline_data.enable);
             continue;
         }
 
-        if (debug_mode() || !pipeline_data.focus.is_null()) {
-            const json::value reco_cb_detail {
-                { "task_id", task_id() },
-                { "reco_id", 0 },
-                { "name", node },
-                { "focus", pipeline_data.focus },
-            };
-            notify(MaaMsg_Node_Recognition_Starting, reco_cb_detail);
-        }
+        notify_reco_starting(pipeline_data);
 
         RecoResult result = recognizer.recognize(pipeline_data);
 
-        if (debug_mode() || !pipeline_data.focus.is_null()) {
-            const json::value reco_cb_detail {
-                { "task_id", task_id() },
-                { "reco_id", result.reco_id },
-                { "name", node },
-                { "focus", pipeline_data.focus },
-            };
-            notify(result.box ? MaaMsg_Node_Recognition_Succeeded : MaaMsg_Node_Recognition_Failed, reco_cb_detail);
-        }
+        notify_reco_result(pipeline_data, result);
 
         if (!result.box) {
             continue;
         }
 
         LogInfo << "node hit" << VAR(result.name) << VAR(result.box);
+        return result;
+    }
+
+    return {};
+}
+
+RecoResult TaskBase::recognize_list_parallel(const cv::Mat& image, const PipelineData::NextList& list)
+{
+    using namespace MAA_RES_NS::Recognition;
 
-        if (debug_mode() || !node_opt->focus.is_null()) {
-            notify(MaaMsg_Node_NextList_Succeeded, reco_list_cb_detail);
+    // a snapshot for the workers. a custom recognition may override the nodes after it, so the nodes are looked up
+    // again in order below, and the ones that changed are recognized again.
+    std::vector<PipelineDataPtr> candidates;
+    for (const auto& node : list) {
+        auto data_ptr = context_->get_pipeline_data(node);
+        candidates.emplace_back(data_ptr && data_ptr->enable ? std::move(data_ptr) : nullptr);
+    }
+
+    // the lowest index that has hit so far. workers with a higher index skip their recognition.
+    auto hit_index = std::make_shared<std::atomic_size_t>(SIZE_MAX);
+    auto update_hit = [](std::atomic_size_t& hit, size_t index) {
+        size_t cur = hit.load();
+        while (index < cur && !hit.compare_exchange_weak(cur, index)) {
         }
+    };
 
-        return result;
+    // nullopt: skipped by the worker
+    std::vector<std::future<std::optional<RecoResult>>> futures(candidates.size());
+    auto& pool = tasker_->reco_pool();
+
+    for (size_t i = 0; i != candidates.size(); ++i) {
+        const auto& data = candidates.at(i);
+        if (!data) {
+            continue;
+        }
+
+        // DirectHit is free, and custom recognitions call back into user code which is not guaranteed to be thread-safe,
+        // so both are run in order on the current thread.
+        if (data->reco_type == Type::DirectHit || data->reco_type == Type::Custom) {
+            if (data->reco_type == Type::DirectHit && !data->inverse) {
+                // nothing behind a DirectHit can ever be reached
+                break;
+            }
+            continue;
+        }
+
+        futures[i] = pool.submit(
+            [tasker = tasker_, context = context_, image, data, i, hit_index, update_hit]() -> std::optional<RecoResult> {
+                if (hit_index->load() < i) {
+                    // an earlier candidate has hit, this result is most likely not needed
+                    return std::nullopt;
+                }
+
+                Recognizer recognizer(tasker, *context, image);
+                // a result behind the hit is thrown away, so none of them is recorded here
+                recognizer.set_deferred(true);
+                RecoResult result = recognizer.recognize(*data);
+                if (result.box) {
+                    update_hit(*hit_index, i);
+                }
+                return result;
+            });
     }
 
-    if (debug_mode() || !node_opt->focus.is_null()) {
-        notify(MaaMsg_Node_NextList_Failed, reco_list_cb_detail);
+    Recognizer recognizer(tasker_, *context_, image);
+
+    for (size_t i = 0; i != list.size(); ++i) {
+        const auto& node = list.at(i);
+        auto data_ptr = context_->get_pipeline_data(node);
+        if (!data_ptr) {
+            LogError << "get_pipeline_data failed, node not exist" << VAR(node);
+            continue;
+        }
+        const auto& pipeline_data = *data_ptr;
+
+        if (!pipeline_data.enable) {
+            LogDebug << "node disabled" << node << VAR(pipeline_data.enable);
+            continue;
+        }
+
+        notify_reco_starting(pipeline_data);
+
+        std::optional<RecoResult> done;
+        if (auto& future = futures.at(i); future.valid() && data_ptr == candidates.at(i)) {
+            done = future.get();
+            if (done) {
+                recognizer.commit(pipeline_data.name, *done);
+            }
+        }
+        else if (future.valid()) {
+            LogDebug << "node overridden by a custom recognition, recognize it again" << VAR(node);
+        }
+        RecoResult result = done ? std::move(*done) : recognizer.recognize(pipeline_data);
+
+        notify_reco_result(pipeline_data, result);
+
+        if (!result.box) {
+            continue;
+        }
+
+        // cancel the candidates that have not started yet, the running ones are left to finish on their own
+        update_hit(*hit_index, i);
+
+        LogInfo << "node hit" << VAR(result.name) << VAR(result.box);
+        return result;
     }
 
     return {};
@@ -156,12 +258,12 @@ NodeDetail TaskBase::run_action(const RecoResult& reco)
         return {};
     }
 
-    auto node_opt = context_->get_pipeline_data(reco.name);
-    if (!node_opt) {
+    auto node_ptr = context_->get_pipeline_data(reco.name);
+    if (!node_ptr) {
         LogError << "get_pipeline_data failed, node not exist" << VAR(reco.name);
         return {};
     }
-    const auto& pipeline_data = *node_opt;
+    const auto& pipeline_data = *node_ptr;
 
     if (debug_mode() || !pipeline_data.focus.is_null()) {
         const json::value cb_detail {
@@ -247,6 +349,36 @@ bool TaskBase::debug_mode() const
     return GlobalOptionMgr::get_instance().debug_mode();
 }
 
+void TaskBase::notify_reco_starting(const PipelineData& pipeline_data)
+{
+    if (!debug_mode() && pipeline_data.focus.is_null()) {
+        return;
+    }
+
+    const json::value reco_cb_detail {
+        { "task_id", task_id() },
+        { "reco_id", 0 },
+        { "name", pipeline_data.name },
+        { "focus", pipeline_data.focus },
+    };
+    notify(MaaMsg_Node_Recognition_Starting, reco_cb_detail);
+}
+
+void TaskBase::notify_reco_result(const PipelineData& pipeline_data, const RecoResult& result)
+{
+    if (!debug_mode() && pipeline_data.focus.is_null()) {
+        return;
+    }
+
+    const json::value reco_cb_detail {
+        { "task_id", task_id() },
+        { "reco_id", result.reco_id },
+        { "name", pipeline_data.name },
+        { "focus", pipeline_data.focus },
+    };
+    notify(result.box ? MaaMsg_Node_Recognition_Succeeded : MaaMsg_Node_Recognition_Failed, reco_cb_detail);
+}
+
 void TaskBase::notify(std::string_view msg, const json::value detail)
 {
     if (!tasker_) {
@@ -19,6 +19,7 @@ class TaskBase
 {
 public:
     using PipelineData = Context::PipelineData;
+    using PipelineDataPtr = Context::PipelineDataPtr;
     using PipelineDataMap = Context::PipelineDataMap;
 
 public:
@@ -58,7 +59,12 @@ protected:
     std::shared_ptr<Context> context_ = nullptr;
 
 private:
+    RecoResult recognize_list(const cv::Mat& image, const PipelineData::NextList& list);
+    RecoResult recognize_list_parallel(const cv::Mat& image, const PipelineData::NextList& list);
+
     bool debug_mode() const;
+    void notify_reco_starting(const PipelineData& pipeline_data);
+    void notify_reco_result(const PipelineData& pipeline_data, const RecoResult& result);
     void notify(std::string_view msg, const json::value detail);
 
 private:
@@ -40,6 +40,8 @@ bool Tasker::bind_resource(MaaResource* resource)
     }
 
     resource_ = derived;
+    // the cached results belong to the models of the previous resource
+    ocr_cache_.clear();
     return true;
 }
 
@@ -158,6 +160,7 @@ void Tasker::clear_cache()
     }
 
     runtime_cache().clear();
+    ocr_cache_.clear();
 }
 
 std::optional<MAA_TASK_NS::TaskDetail> Tasker::get_task_detail(MaaTaskId task_id) const
@@ -190,6 +193,29 @@ const RuntimeCache& Tasker::runtime_cache() const
     return runtime_cache_;
 }
 
+ThreadPool& Tasker::reco_pool()
+{
+    std::unique_lock lock(reco_pool_mutex_);
+
+    if (!reco_pool_) {
+        reco_pool_ = std::make_unique<ThreadPool>();
+    }
+    return *reco_pool_;
+}
+
+MAA_VISION_NS::OCRer::SharedCache& Tasker::ocr_cache()
+{
+    // a bundle loaded into the bound resource may bring other models under the same names
+    if (resource_) {
+        uint64_t generation = resource_->generation();
+        if (ocr_cache_generation_.exchange(generation) != generation) {
+            LogDebug << "resource reloaded, clear OCR cache" << VAR(generation);
+            ocr_cache_.clear();
+        }
+    }
+    return ocr_cache_;
+}
+
 void Tasker::notify(std::string_view msg, const json::value& detail)
 {
     notifier_.notify(msg, detail);
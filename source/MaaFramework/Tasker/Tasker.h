@@ -1,16 +1,19 @@
 #pragma once
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <shared_mutex>
 #include <vector>
 
 #include "Base/AsyncRunner.hpp"
+#include "Base/ThreadPool.hpp"
 #include "Common/MaaTypes.h"
 #include "Controller/ControllerAgent.h"
 #include "Resource/ResourceMgr.h"
 #include "RuntimeCache.h"
 #include "Utils/MessageNotifier.hpp"
+#include "Vision/OCRer.h"
 
 MAA_TASK_NS_BEGIN
 class TaskBase;
@@ -51,6 +54,8 @@ public:
 public:
     RuntimeCache& runtime_cache();
     const RuntimeCache& runtime_cache() const;
+    ThreadPool& reco_pool();
+    MAA_VISION_NS::OCRer::SharedCache& ocr_cache();
     void notify(std::string_view msg, const json::value& detail);
 
 private:
@@ -77,7 +82,14 @@ private:
     TaskPtr running_task_ = nullptr;
 
     RuntimeCache runtime_cache_;
+    MAA_VISION_NS::OCRer::SharedCache ocr_cache_ { MAA_VISION_NS::OCRer::kSharedCacheCapacity };
+    // the generation of resource_ the cached results were recognized with
+    std::atomic_uint64_t ocr_cache_generation_ = 0;
     MessageNotifier notifier_;
+
+    // declared last so that in-flight recognitions are joined before the members they touch are destroyed
+    std::unique_ptr<ThreadPool> reco_pool_ = nullptr;
+    std::mutex reco_pool_mutex_;
 };
 
 MAA_NS_END
@@ -19,11 +19,17 @@ FeatureMatcher::FeatureMatcher(
     cv::Rect roi,
     FeatureMatcherParam param,
     std::vector<std::shared_ptr<cv::Mat>> templates,
+    std::vector<std::shared_ptr<const Template>> template_features,
+    SceneCache& scene_cache,
     std::string name)
     : VisionBase(std::move(image), std::move(roi), std::move(name))
     , param_(std::move(param))
     , templates_(std::move(templates))
+    , template_features_(std::move(template_features))
+    , scene_cache_(scene_cache)
 {
+    template_features_.resize(templates_.size());
+
     analyze();
 }
 
@@ -36,15 +42,21 @@ void FeatureMatcher::analyze()
 
     auto start_time = std::chrono::steady_clock::now();
 
-    for (const auto& templ_ptr : templates_) {
+    const Features& scene = scene_features();
+
+    for (size_t i = 0; i != templates_.size(); ++i) {
+        const auto& templ_ptr = templates_.at(i);
         if (!templ_ptr) {
             continue;
         }
         const auto& templ = *templ_ptr;
 
-        auto [keypoints_1, descriptors_1] = detect(templ, create_mask(templ, param_.green_mask));
+        auto& templ_features = template_features_.at(i);
+        if (!templ_features) {
+            templ_features = prepare_template(templ);
+        }
 
-        auto results = feature_match(templ, keypoints_1, descriptors_1);
+        auto results = feature_match(templ, *templ_features, scene);
         add_results(std::move(results), param_.count);
     }
 
@@ -55,12 +67,32 @@ void FeatureMatcher::analyze()
              << VAR(param_.template_paths) << VAR(param_.green_mask) << VAR(param_.distance_ratio) << VAR(param_.count);
 }
 
-FeatureMatcher::ResultsVec
-    FeatureMatcher::feature_match(const cv::Mat& templ, const std::vector<cv::KeyPoint>& keypoints_1, const cv::Mat& descriptors_1) const
+const FeatureMatcher::Features& FeatureMatcher::scene_features()
+{
+    auto& roi_cache = scene_cache_[param_.detector];
+    if (auto iter = roi_cache.find(roi_); iter != roi_cache.end()) {
+        LogDebug << name_ << VAR(uid_) << "scene features hit cache" << VAR(roi_) << VAR(iter->second.keypoints.size());
+        return iter->second;
+    }
+
+    auto features = detect(image_, create_mask(image_, roi_));
+    return roi_cache.emplace(roi_, std::move(features)).first->second;
+}
+
+std::shared_ptr<const FeatureMatcher::Template> FeatureMatcher::prepare_template(const cv::Mat& templ) const
+{
+    auto prepared = std::make_shared<Template>();
+    prepared->features = detect(templ, create_mask(templ, param_.green_mask));
+    prepared->matcher = train_matcher(prepared->features.descriptors);
+    return prepared;
+}
+
+FeatureMatcher::ResultsVec FeatureMatcher::feature_match(const cv::Mat& templ, const Template& templ_features, const Features& scene) const
 {
-    auto [keypoints_2, descriptors_2] = detect(image_, create_mask(image_, roi_));
+    const auto& keypoints_1 = templ_features.features.keypoints;
+    const auto& keypoints_2 = scene.keypoints;
 
-    auto match_points = match(descriptors_1, descriptors_2);
+    auto match_points = match(templ_features, scene.descriptors);
 
     std::vector<cv::DMatch> good_matches;
     ResultsVec results = feature_postproc(match_points, keypoints_1, keypoints_2, templ.cols, templ.rows, good_matches);
@@ -75,31 +107,48 @@ FeatureMatcher::ResultsVec
 
 cv::Ptr<cv::Feature2D> FeatureMatcher::create_detector() const
 {
+    // detectors are created with default parameters only, so one per thread is enough
+    thread_local std::map<FeatureMatcherParam::Detector, cv::Ptr<cv::Feature2D>> s_detectors;
+
+    if (auto iter = s_detectors.find(param_.detector); iter != s_detectors.end()) {
+        return iter->second;
+    }
+
+    cv::Ptr<cv::Feature2D> detector;
     switch (param_.detector) {
     case FeatureMatcherParam::Detector::SIFT:
-        return cv::SIFT::create();
+        detector = cv::SIFT::create();
+        break;
     case FeatureMatcherParam::Detector::ORB:
-        return cv::ORB::create();
+        detector = cv::ORB::create();
+        break;
     case FeatureMatcherParam::Detector::BRISK:
-        return cv::BRISK::create();
+        detector = cv::BRISK::create();
+        break;
     case FeatureMatcherParam::Detector::KAZE:
-        return cv::KAZE::create();
+        detector = cv::KAZE::create();
+        break;
     case FeatureMatcherParam::Detector::AKAZE:
-        return cv::AKAZE::create();
+        detector = cv::AKAZE::create();
+        break;
     case FeatureMatcherParam::Detector::SURF:
 #ifdef MAA_VISION_HAS_XFEATURES2D
-        return cv::xfeatures2d::SURF::create();
+        detector = cv::xfeatures2d::SURF::create();
+        break;
 #else
         LogError << name_ << VAR(uid_) << "SURF not enabled";
         return nullptr;
 #endif
+    default:
+        LogError << name_ << VAR(uid_) << "Unknown detector" << VAR(static_cast<int>(param_.detector));
+        return nullptr;
     }
 
-    LogError << name_ << VAR(uid_) << "Unknown detector" << VAR(static_cast<int>(param_.detector));
-    return nullptr;
+    s_detectors.emplace(param_.detector, detector);
+    return detector;
 }
 
-std::pair<std::vector<cv::KeyPoint>, cv::Mat> FeatureMatcher::detect(const cv::Mat& image, const cv::Mat& mask) const
+FeatureMatcher::Features FeatureMatcher::detect(const cv::Mat& image, const cv::Mat& mask) const
 {
     auto detector = create_detector();
     if (!detector) {
@@ -111,7 +160,7 @@ std::pair<std::vector<cv::KeyPoint>, cv::Mat> FeatureMatcher::detect(const cv::M
     cv::Mat descriptors;
     detector->detectAndCompute(image, mask, keypoints, descriptors);
 
-    return std::make_pair(std::move(keypoints), std::move(descriptors));
+    return Features { .keypoints = std::move(keypoints), .descriptors = std::move(descriptors) };
 }
 
 cv::Ptr<cv::DescriptorMatcher> FeatureMatcher::create_matcher() const
@@ -132,25 +181,40 @@ cv::Ptr<cv::DescriptorMatcher> FeatureMatcher::create_matcher() const
     return nullptr;
 }
 
-std::vector<std::vector<cv::DMatch>> FeatureMatcher::match(const cv::Mat& descriptors_1, const cv::Mat& descriptors_2) const
+cv::Ptr<cv::DescriptorMatcher> FeatureMatcher::train_matcher(const cv::Mat& descriptors) const
 {
-    if (descriptors_1.empty() || descriptors_2.empty()) {
-        LogWarn << name_ << "descriptors is empty";
-        return {};
+    if (descriptors.empty()) {
+        return nullptr;
     }
 
     auto matcher = create_matcher();
     if (!matcher) {
         LogError << name_ << VAR(uid_) << "matcher is empty";
-        return {};
+        return nullptr;
     }
 
-    std::vector<cv::Mat> train_desc(1, descriptors_1);
+    std::vector<cv::Mat> train_desc(1, descriptors);
     matcher->add(train_desc);
     matcher->train();
 
+    return matcher;
+}
+
+std::vector<std::vector<cv::DMatch>> FeatureMatcher::match(const Template& templ_features, const cv::Mat& descriptors_2) const
+{
+    if (templ_features.features.descriptors.empty() || descriptors_2.empty()) {
+        LogWarn << name_ << "descriptors is empty";
+        return {};
+    }
+
+    if (!templ_features.matcher) {
+        LogError << name_ << VAR(uid_) << "matcher is empty";
+        return {};
+    }
+
     std::vector<std::vector<cv::DMatch>> match_points;
-    matcher->knnMatch(descriptors_2, match_points, 2);
+    std::unique_lock lock(templ_features.matcher_mutex);
+    templ_features.matcher->knnMatch(descriptors_2, match_points, 2);
     return match_points;
 }
 
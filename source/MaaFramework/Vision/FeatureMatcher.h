@@ -1,5 +1,6 @@
 #pragma once
 
+#include <map>
 #include <ostream>
 #include <vector>
 
@@ -28,26 +29,40 @@ class FeatureMatcher
     , public RecoResultAPI<FeatureMatcherResult>
 {
 public:
+    using Features = ImageFeatures;
+    using Template = TemplateFeatures;
+    // features of the same image, keyed by detector and roi. must not be shared between different images.
+    using SceneCache = std::map<FeatureMatcherParam::Detector, std::map<cv::Rect, Features, RectComparator>>;
+
+public:
+    // template_features[i] belongs to templates[i]. null ones are prepared here and can be read back by template_features().
     FeatureMatcher(
         cv::Mat image,
         cv::Rect roi,
         FeatureMatcherParam param,
         std::vector<std::shared_ptr<cv::Mat>> templates,
+        std::vector<std::shared_ptr<const Template>> template_features,
+        SceneCache& scene_cache,
         std::string name = "");
 
+    const std::vector<std::shared_ptr<const Template>>& template_features() const { return template_features_; }
+
 private:
     void analyze();
-    ResultsVec feature_match(const cv::Mat& templ, const std::vector<cv::KeyPoint>& keypoints_1, const cv::Mat& descriptors_1) const;
+    const Features& scene_features();
+    std::shared_ptr<const Template> prepare_template(const cv::Mat& templ) const;
+    ResultsVec feature_match(const cv::Mat& templ, const Template& templ_features, const Features& scene) const;
 
     void add_results(ResultsVec results, int count);
     void cherry_pick();
 
 private:
     cv::Ptr<cv::Feature2D> create_detector() const;
-    std::pair<std::vector<cv::KeyPoint>, cv::Mat> detect(const cv::Mat& image, const cv::Mat& mask) const;
+    Features detect(const cv::Mat& image, const cv::Mat& mask) const;
 
     cv::Ptr<cv::DescriptorMatcher> create_matcher() const;
-    std::vector<std::vector<cv::DMatch>> match(const cv::Mat& descriptors_1, const cv::Mat& descriptors_2) const;
+    cv::Ptr<cv::DescriptorMatcher> train_matcher(const cv::Mat& descriptors) const;
+    std::vector<std::vector<cv::DMatch>> match(const Template& templ_features, const cv::Mat& descriptors_2) const;
 
     ResultsVec feature_postproc(
         const std::vector<std::vector<cv::DMatch>>& match_points,
@@ -69,6 +84,8 @@ private:
 private:
     const FeatureMatcherParam param_;
     const std::vector<std::shared_ptr<cv::Mat>> templates_;
+    std::vector<std::shared_ptr<const Template>> template_features_;
+    SceneCache& scene_cache_;
 };
 
 MAA_VISION_NS_END
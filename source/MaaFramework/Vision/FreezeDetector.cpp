@@ -0,0 +1,93 @@
+#include "FreezeDetector.h"
+
+#include "TemplateComparator.h"
+#include "Utils/Logger.h"
+#include "VisionUtils.hpp"
+
+MAA_VISION_NS_BEGIN
+
+FreezeDetector::FreezeDetector(cv::Mat reference, cv::Rect roi, TemplateComparatorParam param)
+    : reference_(std::move(reference))
+    , roi_(std::move(roi))
+    , param_(std::move(param))
+{
+    split_tiles();
+}
+
+FreezeDetector::~FreezeDetector()
+{
+    LogDebug << VAR(roi_) << VAR(tiles_.size()) << VAR(compared_) << VAR(identical_);
+}
+
+bool FreezeDetector::update(const cv::Mat& image)
+{
+    ++compared_;
+
+    if (identical(image)) {
+        ++identical_;
+        return true;
+    }
+
+    TemplateComparator comparator(reference_, image, roi_, param_);
+    if (comparator.best_result()) {
+        return true;
+    }
+
+    bool same_size = image.size() == reference_.size();
+    reference_ = image;
+    if (same_size) {
+        reference_hashes_ = std::move(image_hashes_);
+    }
+    else {
+        split_tiles();
+    }
+    return false;
+}
+
+bool FreezeDetector::identical(const cv::Mat& image)
+{
+    image_hashes_.assign(tiles_.size(), std::nullopt);
+
+    if (tiles_.empty() || image.size() != reference_.size() || image.type() != reference_.type()) {
+        return false;
+    }
+
+    for (size_t i = 0; i < tiles_.size(); ++i) {
+        auto& reference_hash = reference_hashes_[i];
+        if (!reference_hash) {
+            reference_hash = tile_hash(reference_, tiles_[i]);
+        }
+
+        auto& cur_hash = image_hashes_[i];
+        cur_hash = tile_hash(image, tiles_[i]);
+
+        if (*cur_hash != *reference_hash) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void FreezeDetector::split_tiles()
+{
+    tiles_.clear();
+
+    if (!reference_.empty()) {
+        cv::Rect rect = correct_roi(roi_, reference_);
+        for (int y = rect.y; y < rect.br().y; y += kTileSize) {
+            for (int x = rect.x; x < rect.br().x; x += kTileSize) {
+                tiles_.emplace_back(cv::Rect(x, y, kTileSize, kTileSize) & rect);
+            }
+        }
+    }
+
+    reference_hashes_.assign(tiles_.size(), std::nullopt);
+}
+
+uint64_t FreezeDetector::tile_hash(const cv::Mat& image, const cv::Rect& tile)
+{
+    return image_hash(image(tile));
+}
+
+MAA_VISION_NS_END
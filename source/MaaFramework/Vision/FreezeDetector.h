@@ -0,0 +1,48 @@
+#pragma once
+
+#include <optional>
+#include <vector>
+
+#include "Conf/Conf.h"
+#include "Utils/NoWarningCVMat.hpp"
+#include "Utils/NonCopyable.hpp"
+#include "VisionTypes.h"
+
+MAA_VISION_NS_BEGIN
+
+// Tells whether the ROI of successive screenshots stays the same, for wait_freezes.
+// The ROI is split into tiles whose hashes are compared with those of the reference screenshot, stopping at the first
+// differing tile. Only then does it fall back to TemplateComparator, so that `threshold` keeps its meaning.
+// The hashes of a screenshot are computed once and kept when it becomes the reference.
+class FreezeDetector : public NonCopyable
+{
+public:
+    FreezeDetector(cv::Mat reference, cv::Rect roi, TemplateComparatorParam param);
+    ~FreezeDetector();
+
+    // whether `image` is the same as the reference. If not, it becomes the new reference.
+    bool update(const cv::Mat& image);
+
+private:
+    bool identical(const cv::Mat& image);
+    void split_tiles();
+
+    static uint64_t tile_hash(const cv::Mat& image, const cv::Rect& tile);
+
+private:
+    inline static constexpr int kTileSize = 64;
+
+    cv::Mat reference_;
+    const cv::Rect roi_;
+    const TemplateComparatorParam param_;
+
+    std::vector<cv::Rect> tiles_;
+    // computed on demand, a comparison that exits early leaves the rest empty
+    std::vector<std::optional<uint64_t>> reference_hashes_;
+    std::vector<std::optional<uint64_t>> image_hashes_;
+
+    size_t compared_ = 0;
+    size_t identical_ = 0;
+};
+
+MAA_VISION_NS_END
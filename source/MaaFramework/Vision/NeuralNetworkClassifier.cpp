@@ -1,10 +1,13 @@
 #include "NeuralNetworkClassifier.h"
 
+#include <functional>
+#include <numeric>
+#include <ranges>
+
 #include <onnxruntime/onnxruntime_cxx_api.h>
 
 #include "Utils/NoWarningCV.hpp"
 #include "VisionUtils.hpp"
-#include <ranges>
 
 MAA_VISION_NS_BEGIN
 
@@ -12,13 +15,15 @@ NeuralNetworkClassifier::NeuralNetworkClassifier(
     cv::Mat image,
     cv::Rect roi,
     NeuralNetworkClassifierParam param,
-    std::shared_ptr<Ort::Session> session,
+    std::shared_ptr<ONNXSession> session,
     const Ort::MemoryInfo& memory_info,
+    Cache& cache,
     std::string name)
     : VisionBase(std::move(image), std::move(roi), std::move(name))
     , param_(std::move(param))
     , session_(std::move(session))
     , memory_info_(memory_info)
+    , cache_(cache)
 {
     analyze();
 }
@@ -43,41 +48,70 @@ void NeuralNetworkClassifier::analyze()
              << VAR(param_.labels) << VAR(param_.expected);
 }
 
-NeuralNetworkClassifier::Result NeuralNetworkClassifier::classify() const
+void NeuralNetworkClassifier::batch_infer(
+    const cv::Mat& image,
+    const std::vector<cv::Rect>& rois,
+    ONNXSession& session,
+    const Ort::MemoryInfo& memory_info,
+    Cache& cache)
 {
-    if (!session_) {
-        LogError << "OrtSession not loaded";
-        return {};
+    std::vector<cv::Rect> batch;
+    for (const cv::Rect& roi : rois) {
+        cv::Rect corrected = correct_roi(roi, image);
+        if (!cache.contains(corrected) && std::ranges::find(batch, corrected) == batch.end()) {
+            batch.emplace_back(corrected);
+        }
     }
-    // batch_size, channel, height, width
-    // for yolov8, input_shape is { 1, 3, 640, 640 }
-    const auto input_shape = session_->GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
-    if (input_shape.size() != 4) {
-        LogError << "Input shape is not 4" << VAR(input_shape);
-        return {};
+    if (batch.size() < 2) {
+        return;
     }
 
-    cv::Mat image = image_with_roi();
-    cv::Size raw_roi_size(image.cols, image.rows);
+    auto input_shape = session.input_shape();
+    if (input_shape.size() != 4 || input_shape[0] > 0) {
+        LogDebug << "batch dimension is fixed, skip" << VAR(input_shape);
+        return;
+    }
+    input_shape[0] = static_cast<int64_t>(batch.size());
+
     cv::Size input_image_size(static_cast<int>(input_shape[3]), static_cast<int>(input_shape[2]));
-    cv::resize(image, image, input_image_size, 0, 0, cv::INTER_AREA);
-    std::vector<float> input = image_to_tensor(image);
+    const size_t item_size = static_cast<size_t>(input_image_size.area()) * 3;
 
-    Ort::Value input_tensor =
-        Ort::Value::CreateTensor<float>(memory_info_, input.data(), input.size(), input_shape.data(), input_shape.size());
+    // reused by every batch on this thread, only reallocated when it grows
+    thread_local std::vector<float> input;
+    input.resize(item_size * batch.size());
+    for (size_t i = 0; i != batch.size(); ++i) {
+        image_to_tensor(image(batch.at(i)), input_image_size, input.data() + item_size * i);
+    }
 
-    Ort::AllocatorWithDefaultOptions allocator;
-    const std::string in_0 = session_->GetInputNameAllocated(0, allocator).get();
-    const std::string out_0 = session_->GetOutputNameAllocated(0, allocator).get();
-    const std::vector input_names { in_0.c_str() };
-    const std::vector output_names { out_0.c_str() };
+    auto output_tensor = session.run(input, input_shape, memory_info);
+    if (!output_tensor.data || output_tensor.shape.empty() || output_tensor.shape[0] != input_shape[0]) {
+        LogError << "Invalid batch output" << VAR(input_shape) << VAR(output_tensor.shape);
+        return;
+    }
 
-    Ort::RunOptions run_options;
-    auto output_tensor =
-        session_->Run(run_options, input_names.data(), &input_tensor, input_names.size(), output_names.data(), output_names.size());
+    size_t output_size = std::accumulate(output_tensor.shape.begin() + 1, output_tensor.shape.end(), size_t(1), std::multiplies<size_t> {});
+    for (size_t i = 0; i != batch.size(); ++i) {
+        const float* begin = output_tensor.data + output_size * i;
+        cache.emplace(batch.at(i), std::vector<float>(begin, begin + output_size));
+    }
 
-    const float* raw_output = output_tensor[0].GetTensorData<float>();
-    std::vector<float> output(raw_output, raw_output + output_tensor[0].GetTensorTypeAndShapeInfo().GetElementCount());
+    LogDebug << "batch inferred" << VAR(batch.size()) << VAR(input_shape);
+}
+
+NeuralNetworkClassifier::Result NeuralNetworkClassifier::classify() const
+{
+    std::vector<float> output;
+    if (auto iter = cache_.find(roi_); iter != cache_.end()) {
+        LogDebug << name_ << VAR(uid_) << "Hit classifier cache" << VAR(roi_);
+        output = iter->second;
+    }
+    else {
+        output = infer();
+        if (output.empty()) {
+            return {};
+        }
+        cache_.emplace(roi_, output);
+    }
 
     Result res;
     res.raw = std::move(output);
@@ -95,6 +129,41 @@ NeuralNetworkClassifier::Result NeuralNetworkClassifier::classify() const
     return res;
 }
 
+std::vector<float> NeuralNetworkClassifier::infer() const
+{
+    if (!session_) {
+        LogError << "OrtSession not loaded";
+        return {};
+    }
+
+    // batch_size, channel, height, width
+    // for yolov8, input_shape is { 1, 3, 640, 640 }
+    auto input_shape = session_->input_shape();
+    if (input_shape.size() != 4) {
+        LogError << "Input shape is not 4" << VAR(input_shape);
+        return {};
+    }
+    input_shape[0] = 1;
+
+    cv::Mat image = image_with_roi();
+    cv::Size input_image_size(static_cast<int>(input_shape[3]), static_cast<int>(input_shape[2]));
+
+    // reused by every run on this thread, so the tensor is not reallocated each time
+    thread_local std::vector<float> input;
+    image_to_tensor(image, input_image_size, input);
+
+    auto output_tensor = session_->run(input, input_shape, memory_info_);
+    if (!output_tensor.data) {
+        LogError << "Failed to run session";
+        return {};
+    }
+
+    size_t output_size = std::accumulate(output_tensor.shape.begin(), output_tensor.shape.end(), size_t(1), std::multiplies<size_t> {});
+    std::vector<float> output(output_tensor.data, output_tensor.data + output_size);
+
+    return output;
+}
+
 void NeuralNetworkClassifier::add_results(ResultsVec results, const std::vector<size_t>& expected)
 {
     std::ranges::copy_if(results, std::back_inserter(filtered_results_), [&](const auto& res) {
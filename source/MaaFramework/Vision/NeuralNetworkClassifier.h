@@ -1,11 +1,13 @@
 #pragma once
 #pragma once
 
+#include <map>
 #include <ostream>
 #include <vector>
 
 #include <onnxruntime/onnxruntime_cxx_api.h>
 
+#include "ONNXSession.h"
 #include "Utils/JsonExt.hpp"
 #include "VisionBase.h"
 #include "VisionTypes.h"
@@ -28,19 +30,34 @@ class NeuralNetworkClassifier
     : public VisionBase
     , public RecoResultAPI<NeuralNetworkClassifierResult>
 {
+public:
+    // raw outputs of one model on one image, keyed by roi
+    using Cache = std::map<cv::Rect, std::vector<float>, RectComparator>;
+
 public:
     NeuralNetworkClassifier(
         cv::Mat image,
         cv::Rect roi,
         NeuralNetworkClassifierParam param,
-        std::shared_ptr<Ort::Session> session,
+        std::shared_ptr<ONNXSession> session,
         const Ort::MemoryInfo& memory_info,
+        Cache& cache,
         std::string name = "");
 
+    // runs the rois that are not in `cache` yet as a single batch and stores their outputs in it.
+    // does nothing if the batch dimension of the model is fixed.
+    static void batch_infer(
+        const cv::Mat& image,
+        const std::vector<cv::Rect>& rois,
+        ONNXSession& session,
+        const Ort::MemoryInfo& memory_info,
+        Cache& cache);
+
 private:
     void analyze();
 
     Result classify() const;
+    std::vector<float> infer() const;
 
     void add_results(ResultsVec results, const std::vector<size_t>& expected);
     void cherry_pick();
@@ -51,8 +68,9 @@ private:
 
 private:
     const NeuralNetworkClassifierParam param_;
-    std::shared_ptr<Ort::Session> session_ = nullptr;
+    std::shared_ptr<ONNXSession> session_ = nullptr;
     const Ort::MemoryInfo& memory_info_;
+    Cache& cache_;
 };
 
 MAA_VISION_NS_END
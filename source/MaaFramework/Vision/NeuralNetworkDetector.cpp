@@ -13,7 +13,7 @@ NeuralNetworkDetector::NeuralNetworkDetector(
     cv::Mat image,
     cv::Rect roi,
     NeuralNetworkDetectorParam param,
-    std::shared_ptr<Ort::Session> session,
+    std::shared_ptr<ONNXSession> session,
     const Ort::MemoryInfo& memory_info,
     std::string name)
     : VisionBase(std::move(image), std::move(roi), std::move(name))
@@ -54,34 +54,28 @@ NeuralNetworkDetector::ResultsVec NeuralNetworkDetector::detect() const
 
     // batch_size, channel, height, width
     // for yolov8, input_shape is { 1, 3, 640, 640 }
-    const auto input_shape = session_->GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+    auto input_shape = session_->input_shape();
     if (input_shape.size() != 4) {
         LogError << "Input shape is not 4" << VAR(input_shape);
         return {};
     }
+    input_shape[0] = 1;
 
     cv::Mat image = image_with_roi();
     cv::Size raw_roi_size(image.cols, image.rows);
     cv::Size input_image_size(static_cast<int>(input_shape[3]), static_cast<int>(input_shape[2]));
-    cv::resize(image, image, input_image_size, 0, 0, cv::INTER_AREA);
-    std::vector<float> input = image_to_tensor(image);
 
-    Ort::Value input_tensor =
-        Ort::Value::CreateTensor<float>(memory_info_, input.data(), input.size(), input_shape.data(), input_shape.size());
+    // reused by every run on this thread, so the tensor is not reallocated each time
+    thread_local std::vector<float> input;
+    image_to_tensor(image, input_image_size, input);
 
-    Ort::AllocatorWithDefaultOptions allocator;
-    const std::string in_0 = session_->GetInputNameAllocated(0, allocator).get();
-    const std::string out_0 = session_->GetOutputNameAllocated(0, allocator).get();
-    const std::vector input_names { in_0.c_str() };
-    const std::vector output_names { out_0.c_str() };
-
-    Ort::RunOptions run_options;
-    auto output_tensor =
-        session_->Run(run_options, input_names.data(), &input_tensor, input_names.size(), output_names.data(), output_names.size());
-
-    const float* raw_output = output_tensor[0].GetTensorData<float>();
+    auto output_tensor = session_->run(input, input_shape, memory_info_);
     // output_shape is { 1, 5, 8400 }
-    std::vector<int64_t> output_shape = output_tensor[0].GetTensorTypeAndShapeInfo().GetShape();
+    const auto& output_shape = output_tensor.shape;
+    if (!output_tensor.data || output_shape.size() != 3) {
+        LogError << "Invalid output" << VAR(output_shape);
+        return {};
+    }
 
     // yolov8 的 onnx 输出和前面的 v5, v7 等似乎不太一样，目前网上 yolov8 的 demo 较少，文档也没找到
     // 这里的输出解析是我跟着数据推测的：
@@ -93,29 +87,30 @@ NeuralNetworkDetector::ResultsVec NeuralNetworkDetector::detect() const
     // cls2: conf0, conf1, ..... conf8399
     // cls3: conf0, conf1, ..... conf8399
     // ......
-    std::vector<std::vector<float>> output(output_shape[1]);
-    for (int64_t i = 0; i < output_shape[1]; i++) {
-        output[i] = std::vector<float>(raw_output + i * output_shape[2], raw_output + (i + 1) * output_shape[2]);
-    }
+    const size_t output_rows = static_cast<size_t>(output_shape[1]);
+    const size_t output_size = static_cast<size_t>(output_shape[2]);
+    // decoded in place, row j of the output is output_tensor.data + j * output_size
+    auto output = [&](size_t row, size_t col) {
+        return output_tensor.data[row * output_size + col];
+    };
 
     ResultsVec raw_results;
-    const size_t output_size = output.back().size();
     double width_ratio = 1.0 * raw_roi_size.width / input_image_size.width;
     double height_ratio = 1.0 * raw_roi_size.height / input_image_size.height;
 
     for (size_t i = 0; i < output_size; ++i) {
         constexpr size_t kConfidenceIndex = 4;
-        for (size_t j = kConfidenceIndex; j < output.size(); ++j) {
-            float score = output[j][i];
+        for (size_t j = kConfidenceIndex; j < output_rows; ++j) {
+            float score = output(j, i);
             constexpr float kThreshold = 0.3f;
             if (score < kThreshold) {
                 continue;
             }
 
-            int center_x = static_cast<int>(output[0][i]);
-            int center_y = static_cast<int>(output[1][i]);
-            int w = static_cast<int>(output[2][i]);
-            int h = static_cast<int>(output[3][i]);
+            int center_x = static_cast<int>(output(0, i));
+            int center_y = static_cast<int>(output(1, i));
+            int w = static_cast<int>(output(2, i));
+            int h = static_cast<int>(output(3, i));
 
             int x = center_x - w / 2;
             int y = center_y - h / 2;
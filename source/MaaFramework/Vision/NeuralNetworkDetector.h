@@ -3,6 +3,7 @@
 #include <ostream>
 #include <vector>
 
+#include "ONNXSession.h"
 #include "Utils/JsonExt.hpp"
 #include "VisionBase.h"
 #include "VisionTypes.h"
@@ -30,7 +31,7 @@ public:
         cv::Mat image,
         cv::Rect roi,
         NeuralNetworkDetectorParam param,
-        std::shared_ptr<Ort::Session> session,
+        std::shared_ptr<ONNXSession> session,
         const Ort::MemoryInfo& memory_info,
         std::string name = "");
 
@@ -48,7 +49,7 @@ private:
 
 private:
     const NeuralNetworkDetectorParam param_;
-    std::shared_ptr<Ort::Session> session_ = nullptr;
+    std::shared_ptr<ONNXSession> session_ = nullptr;
     const Ort::MemoryInfo& memory_info_;
 };
 
@@ -24,6 +24,7 @@ OCRer::OCRer(
     std::shared_ptr<fastdeploy::vision::ocr::Recognizer> recer,
     std::shared_ptr<fastdeploy::pipeline::PPOCRv3> ocrer,
     Cache& cache,
+    SharedCache* shared_cache,
     std::string name)
     : VisionBase(std::move(image), std::move(roi), std::move(name))
     , param_(std::move(param))
@@ -31,6 +32,7 @@ OCRer::OCRer(
     , recer_(std::move(recer))
     , ocrer_(std::move(ocrer))
     , cache_(cache)
+    , shared_cache_(shared_cache)
 {
     analyze();
 }
@@ -47,6 +49,82 @@ void OCRer::analyze()
     auto cost = duration_since(start_time);
     LogDebug << name_ << VAR(uid_) << VAR(all_results_) << VAR(filtered_results_) << VAR(best_result_) << VAR(cost) << VAR(param_.model)
              << VAR(param_.only_rec) << VAR(param_.expected);
+    if (shared_cache_) {
+        LogDebug << name_ << VAR(uid_) << "shared cache" << VAR(shared_cache_->hits()) << VAR(shared_cache_->misses());
+    }
+}
+
+OCRer::SharedCacheKey OCRer::SharedCacheKey::make(std::string model, bool only_rec, const cv::Mat& image_roi)
+{
+    constexpr uint64_t kCheckSeed = 0x84222325cbf29ce4ULL;
+
+    return SharedCacheKey {
+        .model = std::move(model),
+        .only_rec = only_rec,
+        .image_hash = MAA_VISION_NS::image_hash(image_roi),
+        .image_check = MAA_VISION_NS::image_hash(image_roi, kCheckSeed),
+    };
+}
+
+void OCRer::batch_only_rec(
+    const cv::Mat& image,
+    const std::vector<cv::Rect>& rois,
+    const std::string& model,
+    const std::shared_ptr<fastdeploy::vision::ocr::Recognizer>& recer,
+    Cache& cache,
+    SharedCache* shared_cache)
+{
+    if (!recer) {
+        LogError << "recer is null";
+        return;
+    }
+
+    std::vector<cv::Rect> batch;
+    std::vector<cv::Mat> images;
+    std::vector<SharedCacheKey> keys;
+    for (const cv::Rect& roi : rois) {
+        cv::Rect corrected = correct_roi(roi, image);
+        if (cache.contains(corrected) || std::ranges::find(batch, corrected) != batch.end()) {
+            continue;
+        }
+
+        cv::Mat image_roi = image(corrected);
+        SharedCacheKey key = shared_cache ? SharedCacheKey::make(model, true, image_roi) : SharedCacheKey {};
+        if (shared_cache) {
+            if (auto cached = shared_cache->get(key)) {
+                cache.emplace(corrected, std::move(*cached));
+                continue;
+            }
+        }
+
+        batch.emplace_back(corrected);
+        images.emplace_back(std::move(image_roi));
+        keys.emplace_back(std::move(key));
+    }
+    if (batch.size() < 2) {
+        return;
+    }
+
+    std::vector<std::string> texts;
+    std::vector<float> scores;
+    bool ret = recer->BatchPredict(images, &texts, &scores);
+    if (!ret || texts.size() != batch.size() || scores.size() != batch.size()) {
+        LogWarn << "BatchPredict failed" << VAR(ret) << VAR(batch.size()) << VAR(texts.size()) << VAR(scores.size());
+        return;
+    }
+
+    for (size_t i = 0; i != batch.size(); ++i) {
+        const cv::Rect& roi = batch.at(i);
+        // same as predict_only_rec, the box is relative to the roi
+        Result result { .text = to_u16(texts.at(i)), .box = { 0, 0, roi.width, roi.height }, .score = scores.at(i) };
+        ResultsVec results { std::move(result) };
+        if (shared_cache) {
+            shared_cache->put(std::move(keys.at(i)), results);
+        }
+        cache.emplace(roi, std::move(results));
+    }
+
+    LogDebug << "batch recognized" << VAR(batch.size());
 }
 
 OCRer::ResultsVec OCRer::predict() const
@@ -59,7 +137,24 @@ OCRer::ResultsVec OCRer::predict() const
     }
     else {
         auto image_roi = image_with_roi();
-        results = param_.only_rec ? ResultsVec { predict_only_rec(image_roi) } : predict_det_and_rec(image_roi);
+
+        std::optional<SharedCacheKey> shared_key;
+        std::optional<ResultsVec> shared_results;
+        if (shared_cache_) {
+            shared_key = SharedCacheKey::make(param_.model, param_.only_rec, image_roi);
+            shared_results = shared_cache_->get(*shared_key);
+        }
+
+        if (shared_results) {
+            LogDebug << "Hit OCR shared cache" << VAR(roi_);
+            results = std::move(*shared_results);
+        }
+        else {
+            results = param_.only_rec ? ResultsVec { predict_only_rec(image_roi) } : predict_det_and_rec(image_roi);
+            if (shared_key) {
+                shared_cache_->put(std::move(*shared_key), results);
+            }
+        }
         cache_.emplace(roi_, results);
     }
 
@@ -203,8 +298,20 @@ void OCRer::postproc_trim_(Result& res) const
 
 void OCRer::postproc_replace_(Result& res) const
 {
-    for (const auto& [regex, format] : param_.replace) {
-        auto replaced_text = std::regex_replace(res.text, std::wregex(regex), format);
+    for (size_t i = 0; i != param_.replace.size(); ++i) {
+        const auto& [regex, format] = param_.replace.at(i);
+        const auto& compiled = i < param_.replace_regex.size() ? param_.replace_regex.at(i) : nullptr;
+
+        std::wstring replaced_text;
+        if (compiled) {
+            replaced_text = std::regex_replace(res.text, *compiled, format);
+        }
+        else if (OCRerParam::is_literal_replace(param_.replace.at(i))) {
+            replaced_text = string_replace_all(res.text, regex, format);
+        }
+        else {
+            replaced_text = std::regex_replace(res.text, std::wregex(regex), format);
+        }
         LogDebug << VAR(res.text) << VAR(regex) << VAR(format) << VAR(replaced_text);
         res.text = std::move(replaced_text);
     }
@@ -216,8 +323,21 @@ bool OCRer::filter_by_required(const Result& res, const std::vector<std::wstring
         return true;
     }
 
-    for (const auto& regex : expected) {
-        if (std::regex_search(res.text, std::wregex(regex))) {
+    for (size_t i = 0; i != expected.size(); ++i) {
+        const auto& regex = expected.at(i);
+        const auto& compiled = i < param_.expected_regex.size() ? param_.expected_regex.at(i) : nullptr;
+
+        bool found = false;
+        if (compiled) {
+            found = std::regex_search(res.text, *compiled);
+        }
+        else if (OCRerParam::is_literal(regex)) {
+            found = res.text.find(regex) != std::wstring::npos;
+        }
+        else {
+            found = std::regex_search(res.text, std::wregex(regex));
+        }
+        if (found) {
             return true;
         }
     }
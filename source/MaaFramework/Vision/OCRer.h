@@ -3,6 +3,7 @@
 #include <ostream>
 #include <vector>
 
+#include "Base/LRUCache.hpp"
 #include "Conf/Conf.h"
 
 #include "Utils/Codec.h"
@@ -40,8 +41,34 @@ class OCRer
     , public RecoResultAPI<OCRerResult>
 {
 public:
+    // results of one model and mode (only_rec or not) on the current image, keyed by roi
     using Cache = std::map<cv::Rect, ResultsVec, RectComparator>;
 
+    // results keyed by the content of the roi, so they outlive the image. shared by every task of a tasker.
+    // image_check is a second hash of the roi with another seed, a collision of image_hash alone is not a hit.
+    struct SharedCacheKey
+    {
+        std::string model;
+        bool only_rec = false;
+        uint64_t image_hash = 0;
+        uint64_t image_check = 0;
+
+        static SharedCacheKey make(std::string model, bool only_rec, const cv::Mat& image_roi);
+
+        bool operator==(const SharedCacheKey&) const = default;
+    };
+
+    struct SharedCacheKeyHash
+    {
+        size_t operator()(const SharedCacheKey& key) const
+        {
+            return std::hash<std::string> {}(key.model) ^ static_cast<size_t>(key.image_hash) ^ static_cast<size_t>(key.only_rec);
+        }
+    };
+
+    using SharedCache = LRUCache<SharedCacheKey, ResultsVec, SharedCacheKeyHash>;
+    inline static constexpr size_t kSharedCacheCapacity = 512;
+
 public:
     OCRer(
         cv::Mat image,
@@ -51,8 +78,18 @@ public:
         std::shared_ptr<fastdeploy::vision::ocr::Recognizer> recer,
         std::shared_ptr<fastdeploy::pipeline::PPOCRv3> ocrer,
         Cache& cache,
+        SharedCache* shared_cache = nullptr,
         std::string name = "");
 
+    // recognizes (only_rec) the rois that are not in `cache` yet with a single batch call and stores the results in it
+    static void batch_only_rec(
+        const cv::Mat& image,
+        const std::vector<cv::Rect>& rois,
+        const std::string& model,
+        const std::shared_ptr<fastdeploy::vision::ocr::Recognizer>& recer,
+        Cache& cache,
+        SharedCache* shared_cache = nullptr);
+
 private:
     void analyze();
 
@@ -80,6 +117,7 @@ private:
     std::shared_ptr<fastdeploy::pipeline::PPOCRv3> ocrer_ = nullptr;
 
     Cache& cache_;
+    SharedCache* shared_cache_ = nullptr;
 };
 
 MAA_VISION_NS_END
@@ -0,0 +1,106 @@
+#include "ONNXSession.h"
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+
+#include "Utils/Logger.h"
+
+MAA_VISION_NS_BEGIN
+
+ONNXSession::ONNXSession(Ort::Session session)
+    : session_(std::move(session))
+    , output_memory_info_(Ort::MemoryInfo::CreateCpu(OrtDeviceAllocator, OrtMemTypeDefault))
+{
+    Ort::AllocatorWithDefaultOptions allocator;
+    input_name_ = session_.GetInputNameAllocated(0, allocator).get();
+    output_name_ = session_.GetOutputNameAllocated(0, allocator).get();
+    input_shape_ = session_.GetInputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+    output_shape_ = session_.GetOutputTypeInfo(0).GetTensorTypeAndShapeInfo().GetShape();
+
+    LogDebug << VAR(input_name_) << VAR(output_name_) << VAR(input_shape_) << VAR(output_shape_);
+}
+
+ONNXSession::Output
+    ONNXSession::run(std::vector<float>& input, const std::vector<int64_t>& input_shape, const Ort::MemoryInfo& input_memory_info)
+{
+    // a binding per concurrent run, onnxruntime only guarantees Run() itself to be thread-safe
+    BindingPtr binding = acquire_binding();
+    Ort::IoBinding& io = binding->io;
+
+    Ort::Value input_tensor =
+        Ort::Value::CreateTensor<float>(input_memory_info, input.data(), input.size(), input_shape.data(), input_shape.size());
+    io.BindInput(input_name_.c_str(), input_tensor);
+
+    // the batch size of the output follows the input
+    std::vector<int64_t> shape = output_shape_;
+    if (!shape.empty() && shape.front() < 0 && !input_shape.empty()) {
+        shape.front() = input_shape.front();
+    }
+
+    bool fixed_shape = !shape.empty() && std::ranges::all_of(shape, [](int64_t dim) { return dim > 0; });
+    if (fixed_shape) {
+        // only reallocated when it grows
+        size_t count = std::accumulate(shape.begin(), shape.end(), size_t(1), std::multiplies<size_t> {});
+        binding->output.resize(count);
+        Ort::Value output_tensor =
+            Ort::Value::CreateTensor<float>(output_memory_info_, binding->output.data(), count, shape.data(), shape.size());
+        io.BindOutput(output_name_.c_str(), output_tensor);
+    }
+    else {
+        // let onnxruntime allocate it, the size is unknown until the run
+        io.BindOutput(output_name_.c_str(), output_memory_info_);
+    }
+
+    session_.Run(run_options_, io);
+
+    Output output;
+
+    if (fixed_shape) {
+        output.data = binding->output.data();
+        output.shape = std::move(shape);
+        output.binding = std::move(binding);
+        return output;
+    }
+
+    auto values = io.GetOutputValues();
+    if (values.empty()) {
+        LogError << "no output" << VAR(output_name_);
+        return {};
+    }
+    output.value = std::move(values.front());
+    output.data = output.value.GetTensorData<float>();
+    output.shape = output.value.GetTensorTypeAndShapeInfo().GetShape();
+    return output;
+}
+
+ONNXSession::BindingPtr ONNXSession::acquire_binding()
+{
+    std::unique_ptr<Binding> binding;
+    {
+        std::unique_lock lock(pool_mutex_);
+        if (!pool_.empty()) {
+            binding = std::move(pool_.back());
+            pool_.pop_back();
+        }
+    }
+    if (!binding) {
+        binding = std::make_unique<Binding>(Binding { .io = Ort::IoBinding(session_), .output = {} });
+    }
+    return BindingPtr(binding.release(), BindingReleaser { this });
+}
+
+void ONNXSession::BindingReleaser::operator()(Binding* binding) const
+{
+    if (!binding) {
+        return;
+    }
+    std::unique_ptr<Binding> owned(binding);
+    if (!session) {
+        return;
+    }
+    std::unique_lock lock(session->pool_mutex_);
+    session->pool_.emplace_back(std::move(owned));
+}
+
+MAA_VISION_NS_END
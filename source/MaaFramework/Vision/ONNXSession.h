@@ -0,0 +1,79 @@
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <onnxruntime/onnxruntime_cxx_api.h>
+
+#include "Conf/Conf.h"
+#include "Utils/NonCopyable.hpp"
+
+MAA_VISION_NS_BEGIN
+
+// An Ort::Session with its I/O metadata, queried once at load time. Each run takes an Ort::IoBinding and its output buffer
+// from a small pool, so the session is shared by recognitions running at the same time without holding a lock across
+// Ort::Session::Run, and the buffers are reused instead of reallocated. The pool grows to the number of concurrent runs.
+// Only the first input and the first output are used. Dynamic dimensions are reported as -1.
+class ONNXSession : public NonCopyable
+{
+    struct Binding
+    {
+        Ort::IoBinding io;
+        std::vector<float> output;
+    };
+
+    struct BindingReleaser
+    {
+        ONNXSession* session;
+        void operator()(Binding* binding) const;
+    };
+
+    using BindingPtr = std::unique_ptr<Binding, BindingReleaser>;
+
+public:
+    struct Output
+    {
+        const float* data = nullptr;
+        std::vector<int64_t> shape;
+
+        // whichever of them holds `data`. the binding goes back to the pool when the output is destroyed
+        BindingPtr binding;
+        Ort::Value value { nullptr };
+    };
+
+public:
+    explicit ONNXSession(Ort::Session session);
+
+public:
+    const std::string& input_name() const { return input_name_; }
+
+    const std::string& output_name() const { return output_name_; }
+
+    const std::vector<int64_t>& input_shape() const { return input_shape_; }
+
+    const std::vector<int64_t>& output_shape() const { return output_shape_; }
+
+    // runs on `input` reshaped to `input_shape`, which must outlive the call. thread-safe.
+    // the output must not outlive the session.
+    Output run(std::vector<float>& input, const std::vector<int64_t>& input_shape, const Ort::MemoryInfo& input_memory_info);
+
+private:
+    BindingPtr acquire_binding();
+
+private:
+    Ort::Session session_;
+    Ort::RunOptions run_options_;
+    Ort::MemoryInfo output_memory_info_;
+
+    std::string input_name_;
+    std::string output_name_;
+    std::vector<int64_t> input_shape_;
+    std::vector<int64_t> output_shape_;
+
+    std::mutex pool_mutex_;
+    std::vector<std::unique_ptr<Binding>> pool_;
+};
+
+MAA_VISION_NS_END
@@ -1,5 +1,7 @@
 #include "TemplateMatcher.h"
 
+#include <limits>
+
 #include "Utils/Logger.h"
 #include "Utils/NoWarningCV.hpp"
 #include "Utils/StringMisc.hpp"
@@ -49,7 +51,8 @@ void TemplateMatcher::analyze()
 
     auto cost = duration_since(start_time);
     LogDebug << name_ << VAR(uid_) << VAR(all_results_) << VAR(filtered_results_) << VAR(best_result_) << VAR(cost)
-             << VAR(param_.template_paths) << VAR(param_.thresholds) << VAR(param_.method) << VAR(param_.green_mask);
+             << VAR(param_.template_paths) << VAR(param_.thresholds) << VAR(param_.method) << VAR(param_.green_mask)
+             << VAR(param_.pyramid_level);
 }
 
 TemplateMatcher::ResultsVec TemplateMatcher::template_match(const cv::Mat& templ) const
@@ -61,33 +64,17 @@ TemplateMatcher::ResultsVec TemplateMatcher::template_match(const cv::Mat& templ
         return {};
     }
 
-    cv::Mat matched;
-    cv::matchTemplate(image, templ, matched, param_.method, create_mask(templ, param_.green_mask));
+    cv::Mat mask = create_mask(templ, param_.green_mask);
 
     ResultsVec raw_results;
     Result max_result;
-    for (int col = 0; col < matched.cols; ++col) {
-        for (int row = 0; row < matched.rows; ++row) {
-            float score = matched.at<float>(row, col);
-            if (std::isnan(score) || std::isinf(score)) {
-                continue;
-            }
-
-            if (max_result.score < score) {
-                max_result.score = score;
-                cv::Rect box(col + roi_.x, row + roi_.y, templ.cols, templ.rows);
-                max_result.box = box;
-            }
-
-            constexpr float kThreshold = 0.5f;
-            if (score < kThreshold) {
-                continue;
-            }
-            cv::Rect box(col + roi_.x, row + roi_.y, templ.cols, templ.rows);
-            Result result { .box = box, .score = score };
-            raw_results.emplace_back(result);
-        }
+    if (param_.pyramid_level > 0) {
+        match_pyramid(image, templ, mask, raw_results, max_result);
     }
+    else {
+        match_region(image, { 0, 0, image.cols, image.rows }, templ, mask, raw_results, max_result);
+    }
+
     // At least there is a result
     if (raw_results.empty()) {
         raw_results.emplace_back(max_result);
@@ -103,6 +90,114 @@ TemplateMatcher::ResultsVec TemplateMatcher::template_match(const cv::Mat& templ
     return nms_results;
 }
 
+void TemplateMatcher::match_region(
+    const cv::Mat& image,
+    const cv::Rect& region,
+    const cv::Mat& templ,
+    const cv::Mat& mask,
+    ResultsVec& raw_results,
+    Result& max_result) const
+{
+    cv::Mat matched;
+    cv::matchTemplate(image(region), templ, matched, param_.method, mask);
+
+    // region is relative to image_with_roi()
+    const int offset_x = region.x + roi_.x;
+    const int offset_y = region.y + roi_.y;
+
+    constexpr float kThreshold = 0.5f;
+    double max_score = 0;
+    cv::Point max_loc;
+    auto peaks = find_peaks(matched, kThreshold, max_score, max_loc);
+
+    if (max_result.score < max_score) {
+        max_result.score = max_score;
+        max_result.box = cv::Rect(max_loc.x + offset_x, max_loc.y + offset_y, templ.cols, templ.rows);
+    }
+
+    raw_results.reserve(raw_results.size() + peaks.size());
+    for (const auto& peak : peaks) {
+        cv::Rect box(peak.x + offset_x, peak.y + offset_y, templ.cols, templ.rows);
+        Result result { .box = box, .score = matched.at<float>(peak) };
+        raw_results.emplace_back(result);
+    }
+}
+
+void TemplateMatcher::match_pyramid(
+    const cv::Mat& image,
+    const cv::Mat& templ,
+    const cv::Mat& mask,
+    ResultsVec& raw_results,
+    Result& max_result) const
+{
+    // the downscaled template needs enough pixels left to be distinguishable
+    constexpr int kMinTemplSide = 8;
+
+    int level = param_.pyramid_level;
+    while (level > 0 && (std::min(templ.cols, templ.rows) >> level) < kMinTemplSide) {
+        --level;
+    }
+    if (level == 0) {
+        LogDebug << name_ << VAR(uid_) << "templ is too small for pyramid, fallback to full resolution" << VAR(templ.size())
+                 << VAR(param_.pyramid_level);
+        match_region(image, { 0, 0, image.cols, image.rows }, templ, mask, raw_results, max_result);
+        return;
+    }
+
+    const int scale = 1 << level;
+
+    cv::Mat coarse_image;
+    cv::resize(image, coarse_image, cv::Size(image.cols / scale, image.rows / scale), 0, 0, cv::INTER_AREA);
+    cv::Mat coarse_templ;
+    cv::resize(templ, coarse_templ, cv::Size(templ.cols / scale, templ.rows / scale), 0, 0, cv::INTER_AREA);
+    cv::Mat coarse_mask;
+    // INTER_NEAREST keeps the mask binary
+    cv::resize(mask, coarse_mask, coarse_templ.size(), 0, 0, cv::INTER_NEAREST);
+
+    cv::Mat coarse_matched;
+    cv::matchTemplate(coarse_image, coarse_templ, coarse_matched, param_.method, coarse_mask);
+    cv::patchNaNs(coarse_matched, std::numeric_limits<float>::lowest());
+
+    // downscaling blurs the peaks, so the coarse pass is more permissive than the final threshold
+    constexpr double kCoarseThreshold = 0.3;
+    constexpr size_t kMaxCandidates = 32;
+
+    std::vector<cv::Point> candidates;
+    while (candidates.size() < kMaxCandidates) {
+        double max_val = 0;
+        cv::Point max_loc;
+        cv::minMaxLoc(coarse_matched, nullptr, &max_val, nullptr, &max_loc);
+        if (std::isinf(max_val) || (max_val < kCoarseThreshold && !candidates.empty())) {
+            break;
+        }
+        candidates.emplace_back(max_loc);
+
+        // suppress the neighborhood so that the next peak belongs to another instance
+        cv::Rect neighborhood(
+            max_loc.x - coarse_templ.cols / 2,
+            max_loc.y - coarse_templ.rows / 2,
+            coarse_templ.cols,
+            coarse_templ.rows);
+        neighborhood &= cv::Rect(0, 0, coarse_matched.cols, coarse_matched.rows);
+        coarse_matched(neighborhood).setTo(std::numeric_limits<float>::lowest());
+    }
+
+    // one coarse pixel covers `scale` full-resolution pixels, plus the shift introduced by INTER_AREA
+    const int radius = scale;
+    const cv::Rect image_rect(0, 0, image.cols, image.rows);
+
+    for (const auto& loc : candidates) {
+        cv::Rect region(loc.x * scale - radius, loc.y * scale - radius, templ.cols + 2 * radius, templ.rows + 2 * radius);
+        region &= image_rect;
+        if (region.width < templ.cols || region.height < templ.rows) {
+            continue;
+        }
+        match_region(image, region, templ, mask, raw_results, max_result);
+    }
+
+    LogDebug << name_ << VAR(uid_) << VAR(level) << VAR(candidates.size()) << VAR(raw_results.size());
+}
+
 cv::Mat TemplateMatcher::draw_result(const cv::Mat& templ, const ResultsVec& results) const
 {
     cv::Mat image_draw = draw_roi();
@@ -32,6 +32,15 @@ public:
 private:
     void analyze();
     ResultsVec template_match(const cv::Mat& templ) const;
+    void match_region(
+        const cv::Mat& image,
+        const cv::Rect& region,
+        const cv::Mat& templ,
+        const cv::Mat& mask,
+        ResultsVec& raw_results,
+        Result& max_result) const;
+    void match_pyramid(const cv::Mat& image, const cv::Mat& templ, const cv::Mat& mask, ResultsVec& raw_results, Result& max_result)
+        const;
 
     void add_results(ResultsVec results, double threshold);
     void cherry_pick();
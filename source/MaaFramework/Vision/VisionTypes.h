@@ -1,7 +1,9 @@
 #pragma once
 
 #include <memory>
+#include <mutex>
 #include <ostream>
+#include <regex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -11,6 +13,11 @@
 #include "Conf/Conf.h"
 #include "Utils/NoWarningCVMat.hpp"
 
+namespace cv
+{
+class DescriptorMatcher;
+}
+
 MAA_VISION_NS_BEGIN
 
 struct Target
@@ -54,6 +61,7 @@ struct TemplateMatcherParam
     std::vector<double> thresholds = { kDefaultThreshold };
     int method = kDefaultMethod;
     bool green_mask = false;
+    int pyramid_level = 0; // 0: full resolution only, n: coarse match at 1/(2^n) scale, then refine around candidates
 
     ResultOrderBy order_by = ResultOrderBy::Horizontal;
     int result_index = 0;
@@ -70,6 +78,22 @@ struct OCRerParam
     double threshold = kDefaultThreshold;
     std::vector<std::pair<std::wstring, std::wstring>> replace;
 
+    // compiled from expected and replace (same index) when the pipeline is parsed.
+    // null for the plain-text patterns, which are matched without the regex engine.
+    std::vector<std::shared_ptr<const std::wregex>> expected_regex;
+    std::vector<std::shared_ptr<const std::wregex>> replace_regex;
+
+    static bool is_literal(const std::wstring& pattern)
+    {
+        return !pattern.empty() && pattern.find_first_of(L"\\^$.|?*+()[]{}") == std::wstring::npos;
+    }
+
+    // "$" in the format refers to the match, so such a replacement is never done as plain text
+    static bool is_literal_replace(const std::pair<std::wstring, std::wstring>& replace)
+    {
+        return is_literal(replace.first) && replace.second.find(L'$') == std::wstring::npos;
+    }
+
     ResultOrderBy order_by = ResultOrderBy::Horizontal;
     int result_index = 0;
 };
@@ -202,6 +226,23 @@ inline std::ostream& operator<<(std::ostream& os, const ResultOrderBy& order_by)
     return os;
 }
 
+// keypoints and descriptors of an image, computed by FeatureMatcher
+struct ImageFeatures
+{
+    std::vector<cv::KeyPoint> keypoints;
+    cv::Mat descriptors;
+};
+
+// a FeatureMatcher template after detection. it is cached by TemplateResMgr and shared between runs.
+struct TemplateFeatures
+{
+    ImageFeatures features;
+
+    // trained on features.descriptors, null if there is none. knnMatch must hold matcher_mutex.
+    std::shared_ptr<cv::DescriptorMatcher> matcher;
+    mutable std::mutex matcher_mutex;
+};
+
 struct RectComparator
 {
     bool operator()(const cv::Rect& lhs, const cv::Rect& rhs) const
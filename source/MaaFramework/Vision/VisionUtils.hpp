@@ -1,5 +1,9 @@
 #pragma once
 
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <limits>
 #include <random>
 #include <ranges>
 
@@ -139,61 +143,139 @@ inline static std::optional<size_t> pythonic_index(size_t total, int index)
     return std::nullopt;
 }
 
-// Non-Maximum Suppression
-template <typename ResultsVec>
-inline static ResultsVec NMS(ResultsVec results, double threshold = 0.7)
+// Greedy NMS: in descending order of `rank`, a result is kept if no kept result covers `threshold` of its area.
+// Kept boxes are indexed by a uniform grid, so each result is only tested against its spatial neighbors.
+template <typename ResultsVec, typename Rank, typename Valid>
+inline static ResultsVec greedy_nms(ResultsVec results, double threshold, Rank rank, Valid valid)
 {
-    std::ranges::sort(results, [](const auto& a, const auto& b) { return a.score > b.score; });
+    // small boxes spread over a large area would need a huge and mostly empty grid
+    constexpr size_t kMaxGridCells = 64 * 1024;
+
+    std::ranges::sort(results, std::greater {}, rank);
+    std::erase_if(results, [&](const auto& res) { return !valid(res); });
+
+    if (results.empty()) {
+        return {};
+    }
+
+    int min_x = INT_MAX;
+    int min_y = INT_MAX;
+    int max_x = INT_MIN;
+    int max_y = INT_MIN;
+    int cell = 1;
+    for (const auto& res : results) {
+        min_x = std::min(min_x, res.box.x);
+        min_y = std::min(min_y, res.box.y);
+        max_x = std::max(max_x, res.box.x + res.box.width);
+        max_y = std::max(max_y, res.box.y + res.box.height);
+        cell = std::max({ cell, res.box.width, res.box.height });
+    }
+
+    // a box is never larger than a cell, so it spans at most 2x2 cells
+    const size_t grid_cols = static_cast<size_t>(max_x - min_x) / cell + 1;
+    const size_t grid_rows = static_cast<size_t>(max_y - min_y) / cell + 1;
+    // otherwise each result is tested against all the kept ones, in the same order
+    const bool use_grid = grid_cols * grid_rows <= kMaxGridCells;
+    std::vector<std::vector<size_t>> grid(use_grid ? grid_cols * grid_rows : 0);
+
+    auto for_each_cell = [&](const cv::Rect& box, auto&& func) {
+        const int c_begin = (box.x - min_x) / cell;
+        const int c_end = (std::max(box.x, box.x + box.width - 1) - min_x) / cell;
+        const int r_begin = (box.y - min_y) / cell;
+        const int r_end = (std::max(box.y, box.y + box.height - 1) - min_y) / cell;
+        for (int r = r_begin; r <= r_end; ++r) {
+            for (int c = c_begin; c <= c_end; ++c) {
+                func(grid[static_cast<size_t>(r) * grid_cols + static_cast<size_t>(c)]);
+            }
+        }
+    };
 
     ResultsVec nms_results;
-    for (size_t i = 0; i < results.size(); ++i) {
-        const auto& res1 = results[i];
-        if (res1.score < 0.1f) {
+    for (auto& res : results) {
+        auto covers = [&](const cv::Rect& kept_box) {
+            int iou_area = (kept_box & res.box).area();
+            return iou_area >= threshold * res.box.area();
+        };
+
+        bool suppressed = false;
+        if (res.box.area() == 0) {
+            // the intersection of an empty box is always "large enough"
+            suppressed = !nms_results.empty();
+        }
+        else if (use_grid) {
+            for_each_cell(res.box, [&](const std::vector<size_t>& bucket) {
+                for (size_t index : bucket) {
+                    if (suppressed) {
+                        return;
+                    }
+                    suppressed = covers(nms_results[index].box);
+                }
+            });
+        }
+        else {
+            suppressed = std::ranges::any_of(nms_results, [&](const auto& kept) { return covers(kept.box); });
+        }
+        if (suppressed) {
             continue;
         }
-        auto res1_box = res1.box;
-        nms_results.emplace_back(std::move(res1));
 
-        for (size_t j = i + 1; j < results.size(); ++j) {
-            auto& res2 = results[j];
-            if (res2.score < 0.1f) {
-                continue;
-            }
-            int iou_area = (res1_box & res2.box).area();
-            if (iou_area >= threshold * res2.box.area()) {
-                res2.score = 0;
-            }
+        if (use_grid) {
+            size_t index = nms_results.size();
+            for_each_cell(res.box, [&](std::vector<size_t>& bucket) {
+                if (bucket.empty() || bucket.back() != index) {
+                    bucket.emplace_back(index);
+                }
+            });
         }
+        nms_results.emplace_back(std::move(res));
     }
     return nms_results;
 }
 
+// Non-Maximum Suppression
+template <typename ResultsVec>
+inline static ResultsVec NMS(ResultsVec results, double threshold = 0.7)
+{
+    return greedy_nms(
+        std::move(results),
+        threshold,
+        [](const auto& res) { return res.score; },
+        [](const auto& res) { return res.score >= 0.1f; });
+}
+
 template <typename ResultsVec>
 inline static ResultsVec NMS_for_count(ResultsVec results, double threshold = 0.7)
 {
-    std::ranges::sort(results, [](const auto& a, const auto& b) { return a.count > b.count; });
+    return greedy_nms(
+        std::move(results),
+        threshold,
+        [](const auto& res) { return res.count; },
+        [](const auto& res) { return res.count != 0; });
+}
 
-    ResultsVec nms_results;
-    for (size_t i = 0; i < results.size(); ++i) {
-        const auto& res1 = results[i];
-        if (res1.count == 0) {
-            continue;
-        }
-        auto res1_box = res1.box;
-        nms_results.emplace_back(std::move(res1));
+// Local maxima (3x3) of a score map that are not less than `threshold`, in row-major order.
+// Built on OpenCV's vectorized kernels. Non-finite scores are patched to the lowest value in place.
+inline static std::vector<cv::Point> find_peaks(cv::Mat& score_map, float threshold, double& max_score, cv::Point& max_loc)
+{
+    constexpr float kLowest = std::numeric_limits<float>::lowest();
 
-        for (size_t j = i + 1; j < results.size(); ++j) {
-            auto& res2 = results[j];
-            if (res2.count == 0) {
-                continue;
-            }
-            int iou_area = (res1_box & res2.box).area();
-            if (iou_area >= threshold * res2.box.area()) {
-                res2.count = 0;
-            }
-        }
+    cv::patchNaNs(score_map, kLowest);
+    cv::Mat inf_mask;
+    cv::compare(cv::abs(score_map), std::numeric_limits<float>::max(), inf_mask, cv::CMP_GT);
+    score_map.setTo(kLowest, inf_mask);
+
+    cv::minMaxLoc(score_map, nullptr, &max_score, nullptr, &max_loc);
+
+    cv::Mat dilated;
+    cv::dilate(score_map, dilated, cv::Mat());
+
+    cv::Mat peak_mask = (score_map >= dilated) & (score_map >= threshold);
+
+    std::vector<cv::Point> peaks;
+    if (cv::countNonZero(peak_mask) > 0) {
+        cv::findNonZero(peak_mask, peaks);
     }
-    return nms_results;
+    return peaks;
 }
 
 template <typename T>
@@ -218,38 +300,63 @@ inline static void merge_vector_(ResultsVec& left, ResultsVec right)
     left.insert(left.end(), std::make_move_iterator(right.begin()), std::make_move_iterator(right.end()));
 }
 
-inline static cv::Mat hwc_to_chw(const cv::Mat& src)
+// A fast non-cryptographic 64-bit hash of the size, type and pixels of an image. The rows need not be continuous.
+// Hashes with different seeds collide independently, two of them together make a 128-bit fingerprint.
+inline static uint64_t image_hash(const cv::Mat& image, uint64_t seed = 0xcbf29ce484222325ULL)
 {
-    std::vector<cv::Mat> rgb_images;
-    cv::split(src, rgb_images);
+    uint64_t hash = seed;
+    auto mix = [&hash](uint64_t value) {
+        hash = (hash ^ value) * 0x9e3779b97f4a7c15ULL;
+        hash ^= hash >> 29;
+    };
+
+    mix(static_cast<uint64_t>(image.rows));
+    mix(static_cast<uint64_t>(image.cols));
+    mix(static_cast<uint64_t>(image.type()));
+
+    const size_t row_bytes = image.cols * image.elemSize();
+    for (int row = 0; row < image.rows; ++row) {
+        const uchar* data = image.ptr<uchar>(row);
+
+        size_t i = 0;
+        for (; i + sizeof(uint64_t) <= row_bytes; i += sizeof(uint64_t)) {
+            uint64_t word = 0;
+            std::memcpy(&word, data + i, sizeof(uint64_t));
+            mix(word);
+        }
+        uint64_t tail = 0;
+        std::memcpy(&tail, data + i, row_bytes - i);
+        mix(tail);
+    }
+    return hash;
+}
 
-    // Stretch one-channel image to vector
-    cv::Mat flat_r = rgb_images[0].reshape(1, 1);
-    cv::Mat flat_g = rgb_images[1].reshape(1, 1);
-    cv::Mat flat_b = rgb_images[2].reshape(1, 1);
+// Resize a BGR image to `size` and write it to `tensor` as planar RGB in [0, 1], i.e. one CHW item of an NCHW tensor.
+// The planes of `tensor` are wrapped by cv::Mat headers, so every step writes in place with OpenCV's vectorized kernels.
+inline static void image_to_tensor(const cv::Mat& image, const cv::Size& size, float* tensor)
+{
+    cv::Mat resized = image;
+    if (image.size() != size) {
+        cv::resize(image, resized, size, 0, 0, cv::INTER_AREA);
+    }
+
+    const size_t plane_size = static_cast<size_t>(size.area());
 
-    // Now we can rearrange channels if need
-    cv::Mat matArray[] = { flat_r, flat_g, flat_b };
+    std::vector<cv::Mat> bgr;
+    cv::split(resized, bgr);
 
-    cv::Mat flat_image;
-    // Concatenate three vectors to one
-    cv::hconcat(matArray, 3, flat_image);
-    return flat_image;
+    for (int i = 0; i < 3; ++i) {
+        // BGR -> RGB
+        cv::Mat dst(size, CV_32FC1, tensor + plane_size * (2 - i));
+        bgr[i].convertTo(dst, CV_32F, 1.0 / 255.0);
+    }
 }
 
-inline static std::vector<float> image_to_tensor(const cv::Mat& image)
+// `tensor` is meant to be reused between calls, it is only reallocated when it grows.
+inline static void image_to_tensor(const cv::Mat& image, const cv::Size& size, std::vector<float>& tensor)
 {
-    cv::Mat src = image.clone();
-    cv::cvtColor(src, src, cv::COLOR_BGR2RGB);
-
-    cv::Mat chw = hwc_to_chw(src);
-    cv::Mat chw_32f;
-    chw.convertTo(chw_32f, CV_32F, 1.0 / 255.0);
-
-    size_t tensor_size = 1ULL * src.cols * src.rows * src.channels();
-    std::vector<float> tensor(tensor_size);
-    std::memcpy(tensor.data(), chw_32f.data, tensor_size * sizeof(float));
-    return tensor;
+    tensor.resize(static_cast<size_t>(size.area()) * 3);
+    image_to_tensor(image, size, tensor.data());
 }
 
 inline cv::Rect correct_roi(const cv::Rect& roi, const cv::Mat& image)
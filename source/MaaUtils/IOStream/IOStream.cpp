@@ -1,38 +1,139 @@
 #include "Utils/IOStream/IOStream.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include "Utils/Time.hpp"
 
 MAA_NS_BEGIN
 
+static constexpr size_t kChunkSize = 128 * 1024;
+
 std::string IOStream::read(duration_t timeout)
 {
-    return read_some(std::numeric_limits<size_t>::max(), timeout);
+    std::string result;
+    read_chunks(
+        [&](std::string_view chunk) {
+            result.append(chunk);
+            return true;
+        },
+        timeout);
+    return result;
 }
 
 std::string IOStream::read_some(size_t count, duration_t timeout)
+{
+    std::string result(count, '\0');
+    size_t read_size = read_into(result.data(), count, timeout);
+    result.resize(read_size);
+    return result;
+}
+
+std::string IOStream::read_until(std::string_view delimiter, duration_t timeout)
 {
     auto start_time = std::chrono::steady_clock::now();
     std::string result;
+    // a match cannot start before it
+    size_t searched = 0;
 
-    while (is_open() && result.size() < count && duration_since(start_time) < timeout) {
-        auto data = read_once(count - result.size());
-        result.append(std::move(data));
+    while (true) {
+        if (has_pending()) {
+            result.append(pending_, pending_pos_);
+            pending_.clear();
+            pending_pos_ = 0;
+        }
+
+        size_t pos = result.find(delimiter, searched);
+        if (pos != std::string::npos) {
+            size_t end = pos + delimiter.size();
+            // keep what was read beyond the delimiter for the next reads
+            pending_.assign(result, end);
+            pending_pos_ = 0;
+            result.resize(end);
+            return result;
+        }
+        searched = result.size() >= delimiter.size() ? result.size() - delimiter.size() + 1 : 0;
+
+        if (!is_open() || duration_since(start_time) >= timeout) {
+            return result;
+        }
+
+        size_t read_size = read_available(chunk_buffer(), kChunkSize);
+        result.append(chunk_buffer(), read_size);
     }
+}
 
-    return result;
+size_t IOStream::read_chunks(const ChunkSink& sink, duration_t timeout)
+{
+    auto start_time = std::chrono::steady_clock::now();
+    size_t total = 0;
+
+    if (has_pending()) {
+        std::string_view pending = std::string_view(pending_).substr(pending_pos_);
+        total += pending.size();
+        bool ret = sink(pending);
+        pending_.clear();
+        pending_pos_ = 0;
+        if (!ret) {
+            return total;
+        }
+    }
+
+    while (is_open() && duration_since(start_time) < timeout) {
+        size_t read_size = read_once(chunk_buffer(), kChunkSize);
+        // a blocking read only returns nothing at the end of the stream or on an error, trying again would spin
+        if (read_size == 0) {
+            break;
+        }
+
+        total += read_size;
+        if (!sink(std::string_view(chunk_buffer(), read_size))) {
+            break;
+        }
+    }
+
+    return total;
 }
 
-std::string IOStream::read_until(std::string_view delimiter, duration_t timeout)
+size_t IOStream::read_into(char* buffer, size_t count, duration_t timeout)
 {
     auto start_time = std::chrono::steady_clock::now();
-    std::string result;
 
-    while (is_open() && !result.ends_with(delimiter) && duration_since(start_time) < timeout) {
-        auto data = read_once(1);
-        result.append(std::move(data));
+    size_t total = take_pending(buffer, count);
+    while (total < count && is_open() && duration_since(start_time) < timeout) {
+        size_t read_size = read_once(buffer + total, count - total);
+        // same as in read_chunks
+        if (read_size == 0) {
+            break;
+        }
+        total += read_size;
     }
 
-    return result;
+    return total;
+}
+
+size_t IOStream::take_pending(char* buffer, size_t max_count)
+{
+    size_t count = std::min(max_count, pending_.size() - pending_pos_);
+    if (count == 0) {
+        return 0;
+    }
+
+    memcpy(buffer, pending_.data() + pending_pos_, count);
+    pending_pos_ += count;
+    if (!has_pending()) {
+        pending_.clear();
+        pending_pos_ = 0;
+    }
+    return count;
+}
+
+char* IOStream::chunk_buffer()
+{
+    if (!chunk_buffer_) {
+        chunk_buffer_ = std::make_unique<char[]>(kChunkSize);
+    }
+    return chunk_buffer_.get();
 }
 
 MAA_NS_END
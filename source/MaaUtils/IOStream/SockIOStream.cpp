@@ -107,17 +107,18 @@ void SockIOStream::expires_after(duration_t timeout)
     ios_.expires_after(timeout);
 }
 
-std::string SockIOStream::read_once(size_t max_count)
+size_t SockIOStream::read_once(char* buffer, size_t max_count)
 {
-    constexpr size_t kBufferSize = 128 * 1024;
+    return static_cast<size_t>(ios_.read(buffer, static_cast<std::streamsize>(max_count)).gcount());
+}
 
-    if (!buffer_) {
-        buffer_ = std::make_unique<char[]>(kBufferSize);
+size_t SockIOStream::read_available(char* buffer, size_t max_count)
+{
+    // peek blocks until the stream buffer is filled with what has arrived, readsome then takes it without blocking again
+    if (ios_.peek() == std::char_traits<char>::eof()) {
+        return 0;
     }
-
-    size_t count = std::min(kBufferSize, max_count);
-    auto read = ios_.read(buffer_.get(), count).gcount();
-    return std::string(buffer_.get(), read);
+    return static_cast<size_t>(ios_.readsome(buffer, static_cast<std::streamsize>(max_count)));
 }
 
 MAA_NS_END
@@ -0,0 +1,176 @@
+#include "ImageDumper.h"
+
+#include <algorithm>
+#include <format>
+
+#include "Utils/ImageIo.h"
+#include "Utils/Logger.h"
+#include "Utils/Platform.h"
+#include "Utils/Time.hpp"
+#include "Utils/Uuid.h"
+
+MAA_LOG_NS_BEGIN
+
+ImageDumper::ImageDumper()
+{
+    thread_ = std::thread(&ImageDumper::working, this);
+}
+
+ImageDumper::~ImageDumper()
+{
+    stop();
+}
+
+void ImageDumper::stop()
+{
+    {
+        std::unique_lock lock(mutex_);
+        if (exit_) {
+            return;
+        }
+        exit_ = true;
+        queue_cond_.notify_all();
+        idle_cond_.notify_all();
+    }
+
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    LogDebug << VAR(written_) << VAR(skipped_);
+}
+
+std::string ImageDumper::dump(const std::filesystem::path& dumps_dir, const cv::Mat& image)
+{
+    std::string extension;
+    std::vector<int> params;
+    {
+        std::unique_lock lock(mutex_);
+
+        if (exit_) {
+            return "Image skipped, exiting";
+        }
+        if (rate_limit_ > 0) {
+            auto now = std::chrono::steady_clock::now();
+            if (now - window_start_ >= std::chrono::seconds(1)) {
+                window_start_ = now;
+                window_count_ = 0;
+            }
+            if (window_count_ >= rate_limit_) {
+                ++skipped_;
+                return "Image skipped, too many per second";
+            }
+        }
+        if (queue_.size() >= kMaxPending) {
+            ++skipped_;
+            return "Image skipped, too many pending";
+        }
+
+        ++window_count_;
+        extension = extension_;
+        params = this->params();
+    }
+
+    std::string filename = std::format("{}-{}{}", format_now_for_filename(), make_uuid(), extension);
+    auto filepath = dumps_dir / path(filename);
+    // the caller may draw on it as soon as the log statement ends
+    Item item { .path = filepath, .image = image.clone(), .params = std::move(params) };
+
+    std::unique_lock lock(mutex_);
+    // the writer may have drained the queue and quit meanwhile
+    if (exit_) {
+        return "Image skipped, exiting";
+    }
+    queue_.emplace_back(std::move(item));
+    queue_cond_.notify_one();
+
+    return path_to_utf8_string(filepath);
+}
+
+void ImageDumper::wait()
+{
+    std::unique_lock lock(mutex_);
+    idle_cond_.wait(lock, [&]() { return exit_ || (queue_.empty() && writing_ == 0); });
+}
+
+bool ImageDumper::set_format(std::string_view format)
+{
+    std::unique_lock lock(mutex_);
+
+    if (format == "png") {
+        extension_ = ".png";
+    }
+    else if (format == "jpg") {
+        extension_ = ".jpg";
+    }
+    else {
+        return false;
+    }
+    return true;
+}
+
+bool ImageDumper::set_quality(int quality)
+{
+    if (quality < -1 || quality > 100) {
+        return false;
+    }
+
+    std::unique_lock lock(mutex_);
+    quality_ = quality;
+    return true;
+}
+
+bool ImageDumper::set_rate_limit(int rate_limit)
+{
+    if (rate_limit < 0) {
+        return false;
+    }
+
+    std::unique_lock lock(mutex_);
+    rate_limit_ = rate_limit;
+    return true;
+}
+
+void ImageDumper::working()
+{
+    while (true) {
+        std::unique_lock lock(mutex_);
+        queue_cond_.wait(lock, [&]() { return exit_ || !queue_.empty(); });
+
+        // written before exiting, their paths are in the log already
+        if (queue_.empty()) {
+            break;
+        }
+
+        Item item = std::move(queue_.front());
+        queue_.pop_front();
+        ++writing_;
+        lock.unlock();
+
+        bool ret = MAA_NS::imwrite(item.path, item.image, item.params);
+        if (!ret) {
+            LogError << "failed to write image" << VAR(item.path);
+        }
+
+        lock.lock();
+        --writing_;
+        if (ret) {
+            ++written_;
+        }
+        idle_cond_.notify_all();
+    }
+}
+
+std::vector<int> ImageDumper::params() const
+{
+    // by default, encoding speed matters more than size for dumps
+    constexpr int kDefaultPngLevel = 1;
+    constexpr int kDefaultJpgQuality = 90;
+
+    if (extension_ == ".jpg") {
+        return { cv::IMWRITE_JPEG_QUALITY, quality_ < 0 ? kDefaultJpgQuality : quality_ };
+    }
+    return { cv::IMWRITE_PNG_COMPRESSION, quality_ < 0 ? kDefaultPngLevel : std::min(quality_, 9) };
+}
+
+MAA_LOG_NS_END
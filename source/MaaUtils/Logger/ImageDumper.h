@@ -0,0 +1,76 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Conf/Conf.h"
+#include "Utils/NoWarningCVMat.hpp"
+#include "Utils/NonCopyable.hpp"
+
+MAA_LOG_NS_BEGIN
+
+// Writes the images passed to the log on a background thread, a log statement only copies the image and names the file.
+// At most kMaxPending images wait to be encoded and, if a rate limit is set, at most that many are taken per second.
+// The others are skipped rather than slowing down the thread that logs them.
+class ImageDumper : public NonCopyable
+{
+public:
+    inline static constexpr size_t kMaxPending = 16;
+
+public:
+    ImageDumper();
+    ~ImageDumper();
+
+    // returns the path the image is going to be written to, or why it is not
+    std::string dump(const std::filesystem::path& dumps_dir, const cv::Mat& image);
+    // blocks until the queued images are written
+    void wait();
+    // writes the queued images and joins the writer, the images dumped afterwards are skipped
+    void stop();
+
+    // "png" or "jpg"
+    bool set_format(std::string_view format);
+    // the zlib level (0-9) of png or the quality (0-100) of jpg, -1 for the default of the format
+    bool set_quality(int quality);
+    // images per second, 0 for no limit
+    bool set_rate_limit(int rate_limit);
+
+private:
+    struct Item
+    {
+        std::filesystem::path path;
+        cv::Mat image;
+        std::vector<int> params;
+    };
+
+    void working();
+    std::vector<int> params() const;
+
+private:
+    std::string extension_ = ".png";
+    int quality_ = -1;
+    int rate_limit_ = 0;
+
+    std::chrono::steady_clock::time_point window_start_ {};
+    int window_count_ = 0;
+
+    std::deque<Item> queue_;
+    size_t writing_ = 0;
+    std::mutex mutex_;
+    std::condition_variable queue_cond_;
+    std::condition_variable idle_cond_;
+    bool exit_ = false;
+
+    size_t written_ = 0;
+    size_t skipped_ = 0;
+
+    std::thread thread_;
+};
+
+MAA_LOG_NS_END
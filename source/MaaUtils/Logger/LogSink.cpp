@@ -0,0 +1,270 @@
+#define _CRT_SECURE_NO_WARNINGS
+
+#include "Utils/LoggerUtils.h"
+
+#include <algorithm>
+
+#ifdef _WIN32
+#include "Utils/SafeWindows.hpp"
+
+#include <io.h>
+#endif
+
+#include "Utils/Platform.h"
+
+MAA_LOG_NS_BEGIN
+
+LogSink::LogSink()
+{
+    tail_ = new Node;
+    head_ = tail_;
+
+    thread_ = std::thread(&LogSink::working, this);
+}
+
+LogSink::~LogSink()
+{
+    {
+        std::unique_lock lock(wake_mutex_);
+        exit_ = true;
+        wake_cond_.notify_all();
+    }
+
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    // pushed after the writer stopped
+    drain();
+    delete tail_;
+}
+
+void LogSink::push(Record record)
+{
+    Node* node = new Node { .record = std::move(record) };
+
+    ++pushed_;
+    Node* prev = head_.exchange(node);
+    prev->next = node;
+
+    // the writer sets sleeping_ before checking for records, so one of them sees the other
+    if (sleeping_) {
+        std::unique_lock lock(wake_mutex_);
+        wake_cond_.notify_one();
+    }
+}
+
+void LogSink::flush()
+{
+    std::unique_lock lock(flush_mutex_);
+
+    uint64_t target = pushed_;
+    flush_target_ = std::max(flush_target_, target);
+
+    {
+        std::unique_lock wake_lock(wake_mutex_);
+        wake_cond_.notify_one();
+    }
+
+    // the writer may be gone without setting stopped_, see writer_running()
+    while (!flush_cond_.wait_for(lock, kFlushInterval, [&]() { return stopped_ || flushed_ >= target; })) {
+        if (!writer_running()) {
+            break;
+        }
+    }
+    lock.unlock();
+
+    if (!writer_running()) {
+        drain();
+    }
+}
+
+void LogSink::open(const std::filesystem::path& path)
+{
+    std::unique_lock lock(file_mutex_);
+    if (ofs_.is_open()) {
+        ofs_.close();
+    }
+
+#ifdef _WIN32
+
+    // https://stackoverflow.com/questions/55513974/controlling-inheritability-of-file-handles-created-by-c-stdfstream-in-window
+    std::string str_log_path = path.string();
+    FILE* file_ptr = fopen(str_log_path.c_str(), "a");
+    SetHandleInformation((HANDLE)_get_osfhandle(_fileno(file_ptr)), HANDLE_FLAG_INHERIT, 0);
+    ofs_ = std::ofstream(file_ptr);
+
+#else
+
+    ofs_ = std::ofstream(path, std::ios::out | std::ios::app);
+
+#endif
+}
+
+void LogSink::close()
+{
+    flush();
+
+    std::unique_lock lock(file_mutex_);
+    if (ofs_.is_open()) {
+        ofs_.close();
+    }
+}
+
+void LogSink::working()
+{
+    std::string stdout_batch;
+    std::string file_batch;
+
+    uint64_t written = 0;
+    uint64_t flushed = 0;
+    auto last_flush = std::chrono::steady_clock::now();
+
+    while (true) {
+        bool urgent = false;
+
+        Record record;
+        while (file_batch.size() < kFlushBytes && pop(record)) {
+            ++written;
+            if (record.to_stdout) {
+                stdout_batch += stdout_string(record);
+                stdout_batch += '\n';
+            }
+            if (record.to_file) {
+                file_batch += record.text;
+                file_batch += '\n';
+            }
+            urgent |= record.lv <= level::error;
+        }
+
+        if (!stdout_batch.empty()) {
+            std::cout << stdout_batch << std::flush;
+            stdout_batch.clear();
+        }
+
+        uint64_t target = 0;
+        {
+            std::unique_lock lock(flush_mutex_);
+            target = flush_target_;
+        }
+
+        bool due = urgent || file_batch.size() >= kFlushBytes || target > flushed
+                   || std::chrono::steady_clock::now() - last_flush >= kFlushInterval;
+        bool exiting = exit_ && !has_pending();
+
+        if (!file_batch.empty() || (written != flushed && (due || exiting))) {
+            std::unique_lock lock(file_mutex_);
+            if (ofs_.is_open()) {
+                ofs_ << file_batch;
+                if (due || exiting) {
+                    ofs_.flush();
+                }
+            }
+            file_batch.clear();
+        }
+
+        if (written != flushed && (due || exiting)) {
+            flushed = written;
+            last_flush = std::chrono::steady_clock::now();
+
+            std::unique_lock lock(flush_mutex_);
+            flushed_ = flushed;
+            flush_cond_.notify_all();
+        }
+
+        if (exiting) {
+            break;
+        }
+
+        std::unique_lock lock(wake_mutex_);
+        sleeping_ = true;
+        if (!has_pending() && !exit_) {
+            // wakes up on its own for the periodic flush
+            wake_cond_.wait_for(lock, kFlushInterval);
+        }
+        sleeping_ = false;
+    }
+
+    std::unique_lock lock(flush_mutex_);
+    stopped_ = true;
+    flush_cond_.notify_all();
+}
+
+bool LogSink::writer_running()
+{
+#ifdef _WIN32
+    // when a DLL is unloaded at process exit, the OS has terminated its threads before the static destructors run
+    if (thread_.joinable() && WaitForSingleObject(thread_.native_handle(), 0) == WAIT_OBJECT_0) {
+        return false;
+    }
+#endif
+
+    return thread_.joinable() && !stopped_;
+}
+
+void LogSink::drain()
+{
+    // file_mutex_ keeps the callers from popping at the same time, the writer does not pop anymore
+    std::unique_lock lock(file_mutex_);
+
+    std::string stdout_batch;
+    std::string file_batch;
+
+    Record record;
+    while (pop(record)) {
+        if (record.to_stdout) {
+            stdout_batch += stdout_string(record);
+            stdout_batch += '\n';
+        }
+        if (record.to_file) {
+            file_batch += record.text;
+            file_batch += '\n';
+        }
+    }
+
+    if (!stdout_batch.empty()) {
+        std::cout << stdout_batch << std::flush;
+    }
+    if (!file_batch.empty() && ofs_.is_open()) {
+        ofs_ << file_batch;
+        ofs_.flush();
+    }
+}
+
+bool LogSink::pop(Record& record)
+{
+    Node* next = tail_->next;
+    if (!next) {
+        return false;
+    }
+
+    record = std::move(next->record);
+    delete tail_;
+    tail_ = next;
+    return true;
+}
+
+std::string LogSink::stdout_string(const Record& record)
+{
+    std::string color;
+
+    switch (record.lv) {
+    case level::fatal:
+    case level::error:
+        color = "\033[31m";
+        break;
+    case level::warn:
+        color = "\033[33m";
+        break;
+    case level::info:
+        color = "\033[32m";
+        break;
+    case level::debug:
+    case level::trace:
+        break;
+    }
+
+    return color + utf8_to_crt(record.text) + "\033[0m";
+}
+
+MAA_LOG_NS_END
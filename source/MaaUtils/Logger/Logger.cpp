@@ -5,16 +5,14 @@
 #ifdef _WIN32
 #include "Utils/SafeWindows.hpp"
 
-#include <io.h>
 #include <sysinfoapi.h>
 #else
 #include <sys/utsname.h>
 #endif
 
+#include "ImageDumper.h"
 #include "Utils/Codec.h"
-#include "Utils/ImageIo.h"
 #include "Utils/Platform.h"
-#include "Utils/Uuid.h"
 
 #pragma message("MaaUtils MAA_VERSION: " MAA_VERSION)
 
@@ -28,29 +26,6 @@ constexpr separator separator::comma(",");
 
 static constexpr std::string_view kSplitLine = "-----------------------------";
 
-std::string LogStream::stdout_string()
-{
-    std::string color;
-
-    switch (lv_) {
-    case level::fatal:
-    case level::error:
-        color = "\033[31m";
-        break;
-    case level::warn:
-        color = "\033[33m";
-        break;
-    case level::info:
-        color = "\033[32m";
-        break;
-    case level::debug:
-    case level::trace:
-        break;
-    }
-
-    return color + utf8_to_crt(buffer_.str()) + "\033[0m";
-}
-
 std::string_view LogStream::level_str()
 {
     switch (lv_) {
@@ -76,6 +51,18 @@ Logger& Logger::get_instance()
     return unique_instance;
 }
 
+Logger::Logger()
+    : image_dumper_(std::make_unique<ImageDumper>())
+{
+}
+
+Logger::~Logger()
+{
+    // the images it is still writing are named in the log already, and its last line goes to the sink before it is closed
+    image_dumper_->stop();
+    close();
+}
+
 void Logger::start_logging(std::filesystem::path dir)
 {
     log_dir_ = std::move(dir);
@@ -95,6 +82,26 @@ void Logger::set_stdout_level(MaaLoggingLevel level)
     stdout_level_ = level;
 }
 
+void Logger::set_file_level(MaaLoggingLevel level)
+{
+    file_level_ = level;
+}
+
+bool Logger::set_image_format(std::string_view format)
+{
+    return image_dumper_->set_format(format);
+}
+
+bool Logger::set_image_quality(int quality)
+{
+    return image_dumper_->set_quality(quality);
+}
+
+bool Logger::set_image_rate_limit(int rate_limit)
+{
+    return image_dumper_->set_rate_limit(rate_limit);
+}
+
 void Logger::flush()
 {
     internal_dbg() << kSplitLine;
@@ -122,10 +129,8 @@ bool Logger::rotate()
         return false;
     }
 
-    std::unique_lock trace_lock(trace_mutex_);
-    if (ofs_.is_open()) {
-        ofs_.close();
-    }
+    sink_.close();
+    image_dumper_->wait();
 
     constexpr uintmax_t MaxLogSize = 16ULL * 1024 * 1024;
     const uintmax_t log_size = std::filesystem::file_size(log_path_);
@@ -156,24 +161,7 @@ void Logger::open()
     }
     std::filesystem::create_directories(log_dir_);
 
-    std::unique_lock trace_lock(trace_mutex_);
-    if (ofs_.is_open()) {
-        ofs_.close();
-    }
-
-#ifdef _WIN32
-
-    // https://stackoverflow.com/questions/55513974/controlling-inheritability-of-file-handles-created-by-c-stdfstream-in-window
-    std::string str_log_path = log_path_.string();
-    FILE* file_ptr = fopen(str_log_path.c_str(), "a");
-    SetHandleInformation((HANDLE)_get_osfhandle(_fileno(file_ptr)), HANDLE_FLAG_INHERIT, 0);
-    ofs_ = std::ofstream(file_ptr);
-
-#else
-
-    ofs_ = std::ofstream(log_path_, std::ios::out | std::ios::app);
-
-#endif
+    sink_.open(log_path_);
 }
 
 void Logger::close()
@@ -182,10 +170,7 @@ void Logger::close()
     internal_dbg() << "Close log";
     internal_dbg() << kSplitLine;
 
-    std::unique_lock trace_lock(trace_mutex_);
-    if (ofs_.is_open()) {
-        ofs_.close();
-    }
+    sink_.close();
 }
 
 static std::string sys_info()
@@ -251,13 +236,7 @@ std::string StringConverter::operator()(const cv::Mat& image) const
         return "Empty image";
     }
 
-    std::string filename = std::format("{}-{}.png", format_now_for_filename(), make_uuid());
-    auto filepath = dumps_dir_ / path(filename);
-    bool ret = MAA_NS::imwrite(filepath, image);
-    if (!ret) {
-        return "Failed to write image";
-    }
-    return this->operator()(filepath);
+    return Logger::get_instance().image_dumper_->dump(dumps_dir_, image);
 }
 
 MAA_LOG_NS_END
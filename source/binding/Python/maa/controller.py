@@ -159,6 +159,17 @@ class Controller:
             )
         )
 
+    def set_screencap_streaming(self, max_age_ms: int) -> bool:
+        cint = ctypes.c_int32(max_age_ms)
+        return bool(
+            Library.framework().MaaControllerSetOption(
+                self._handle,
+                MaaOption(MaaCtrlOptionEnum.ScreencapStreaming),
+                ctypes.pointer(cint),
+                ctypes.sizeof(ctypes.c_int32),
+            )
+        )
+
     ### private ###
 
     def _status(self, maaid: int) -> MaaStatus:
@@ -88,6 +88,31 @@ class MaaGlobalOptionEnum(IntEnum):
     # value: bool, eg: true; val_size: sizeof(bool)
     DebugMode = 6
 
+    # The level of log output to maa.log
+    #
+    # value, val_size: sizeof(MaaLoggingLevel)
+    # default value is MaaLoggingLevel_All
+    FileLevel = 7
+
+    # The format of the images written to the dumps dir when one is logged
+    #
+    # value: string, "png" or "jpg"; val_size: string length
+    # default value is "png"
+    LogImageFormat = 8
+
+    # The maximum number of images written to the dumps dir per second, 0 for no limit
+    #
+    # value: int, eg: 10; val_size: sizeof(int)
+    # default value is 0
+    LogImageRateLimit = 9
+
+    # The compression of the images written to the dumps dir
+    # The zlib level of png, from 0 to 9, or the quality of jpg, from 0 to 100. -1 for the default of the format.
+    #
+    # value: int, eg: 90; val_size: sizeof(int)
+    # default value is -1, i.e. level 1 for png and quality 90 for jpg
+    LogImageQuality = 10
+
 
 class MaaCtrlOptionEnum(IntEnum):
     Invalid = 0
@@ -110,6 +135,11 @@ class MaaCtrlOptionEnum(IntEnum):
     # value: bool, eg: true; val_size: sizeof(bool)
     Recording = 5
 
+    # Capture continuously on a background thread, and let screencaps issued by tasks take the newest frame
+    # not older than this bound (in milliseconds) instead of queueing behind actions. 0 disables it.
+    # value: int, eg: 100; val_size: sizeof(int)
+    ScreencapStreaming = 6
+
 
 class MaaInferenceDeviceEnum(IntEnum):
     CPU = -2
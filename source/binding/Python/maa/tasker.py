@@ -156,6 +156,49 @@ class Tasker:
             )
         )
 
+    @staticmethod
+    def set_file_level(level: LoggingLevelEnum) -> bool:
+        clevel = MaaLoggingLevel(level)
+        return bool(
+            Library.framework().MaaSetGlobalOption(
+                MaaOption(MaaGlobalOptionEnum.FileLevel),
+                ctypes.pointer(clevel),
+                ctypes.sizeof(MaaLoggingLevel),
+            )
+        )
+
+    @staticmethod
+    def set_log_image_format(image_format: str) -> bool:
+        return bool(
+            Library.framework().MaaSetGlobalOption(
+                MaaOption(MaaGlobalOptionEnum.LogImageFormat),
+                image_format.encode(),
+                len(image_format),
+            )
+        )
+
+    @staticmethod
+    def set_log_image_quality(quality: int) -> bool:
+        cint = ctypes.c_int32(quality)
+        return bool(
+            Library.framework().MaaSetGlobalOption(
+                MaaOption(MaaGlobalOptionEnum.LogImageQuality),
+                ctypes.pointer(cint),
+                ctypes.sizeof(ctypes.c_int32),
+            )
+        )
+
+    @staticmethod
+    def set_log_image_rate_limit(rate_limit: int) -> bool:
+        cint = ctypes.c_int32(rate_limit)
+        return bool(
+            Library.framework().MaaSetGlobalOption(
+                MaaOption(MaaGlobalOptionEnum.LogImageRateLimit),
+                ctypes.pointer(cint),
+                ctypes.sizeof(ctypes.c_int32),
+            )
+        )
+
     @staticmethod
     def set_show_hit_draw(show_hit_draw: bool) -> bool:
         cbool = ctypes.c_bool(show_hit_draw)
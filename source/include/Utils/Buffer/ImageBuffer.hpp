@@ -55,6 +55,7 @@ public:
 
     virtual const cv::Mat& get() const override { return image_; }
 
+    // the buffer hands out writable pixels through the C API, so it keeps its own copy
     virtual void set(cv::Mat image) override
     {
         dirty_ = true;
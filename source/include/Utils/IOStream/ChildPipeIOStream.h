@@ -32,7 +32,8 @@ public:
     virtual bool is_open() const override;
 
 protected:
-    virtual std::string read_once(size_t max_count) override;
+    virtual size_t read_once(char* buffer, size_t max_count) override;
+    virtual size_t read_available(char* buffer, size_t max_count) override;
 
 private:
     using os_string = std::filesystem::path::string_type;
@@ -46,8 +47,6 @@ private:
     boost::process::ipstream pin_;
     boost::process::opstream pout_;
     boost::process::child child_;
-
-    std::unique_ptr<char[]> buffer_ = nullptr;
 };
 
 MAA_NS_END
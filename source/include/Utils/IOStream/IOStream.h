@@ -1,6 +1,8 @@
 #pragma once
 
 #include <chrono>
+#include <functional>
+#include <memory>
 #include <string>
 #include <string_view>
 
@@ -14,6 +16,8 @@ class MAA_UTILS_API IOStream
 {
 public:
     using duration_t = std::chrono::milliseconds;
+    // returns false to stop reading
+    using ChunkSink = std::function<bool(std::string_view chunk)>;
 
     virtual ~IOStream() = default;
 
@@ -23,12 +27,31 @@ public:
     virtual std::string read(duration_t timeout = duration_t::max());
     virtual std::string read_some(size_t count, duration_t timeout = duration_t::max());
     virtual std::string read_until(std::string_view delimiter, duration_t timeout = duration_t::max());
+    // hands the data to `sink` as it arrives instead of collecting it, returns the number of bytes read
+    virtual size_t read_chunks(const ChunkSink& sink, duration_t timeout = duration_t::max());
+    // reads `count` bytes straight into `buffer`, returns less only if the stream ends or the timeout expires
+    virtual size_t read_into(char* buffer, size_t count, duration_t timeout = duration_t::max());
 
     virtual bool release() = 0;
     virtual bool is_open() const = 0;
 
 protected:
-    virtual std::string read_once(size_t max_count) = 0;
+    // blocks until `max_count` bytes are read or the stream ends
+    virtual size_t read_once(char* buffer, size_t max_count) = 0;
+    // blocks until some data is available, then reads at most `max_count` bytes of what is available
+    virtual size_t read_available(char* buffer, size_t max_count) = 0;
+
+private:
+    bool has_pending() const { return pending_pos_ < pending_.size(); }
+
+    size_t take_pending(char* buffer, size_t max_count);
+    char* chunk_buffer();
+
+    // read ahead by read_until, served before anything else
+    std::string pending_;
+    size_t pending_pos_ = 0;
+
+    std::unique_ptr<char[]> chunk_buffer_ = nullptr;
 };
 
 MAA_NS_END
@@ -63,12 +63,11 @@ public:
     void expires_after(duration_t timeout);
 
 protected:
-    virtual std::string read_once(size_t max_count) override;
+    virtual size_t read_once(char* buffer, size_t max_count) override;
+    virtual size_t read_available(char* buffer, size_t max_count) override;
 
 private:
     boost::asio::ip::tcp::iostream ios_;
-
-    std::unique_ptr<char[]> buffer_ = nullptr;
 };
 
 MAA_NS_END
@@ -1,10 +1,24 @@
 #pragma once
 
+#include <atomic>
+#include <memory>
+
 #include "Utils/LoggerUtils.h"
 #include "Utils/ScopeLeave.hpp"
 
+// trace logs are compiled out of release builds, define MAA_LOG_TRACE to 1 to keep them
+#ifndef MAA_LOG_TRACE
+#ifdef MAA_DEBUG
+#define MAA_LOG_TRACE 1
+#else
+#define MAA_LOG_TRACE 0
+#endif
+#endif
+
 MAA_LOG_NS_BEGIN
 
+class ImageDumper;
+
 class MAA_UTILS_API Logger
 {
 public:
@@ -16,7 +30,7 @@ public:
 public:
     static Logger& get_instance();
 
-    ~Logger() { close(); }
+    ~Logger();
 
     Logger(const Logger&) = delete;
     Logger(Logger&&) = delete;
@@ -59,20 +73,35 @@ public:
         return stream(level::trace, std::forward<args_t>(args)...);
     }
 
+    // checked by the Log macros before anything is formatted
+    bool enabled(level lv) const
+    {
+        int lv_int = static_cast<int>(lv);
+        return lv_int <= stdout_level_ || lv_int <= file_level_;
+    }
+
     void start_logging(std::filesystem::path dir);
     void set_stdout_level(MaaLoggingLevel level);
+    void set_file_level(MaaLoggingLevel level);
+    bool set_image_format(std::string_view format);
+    bool set_image_quality(int quality);
+    bool set_image_rate_limit(int rate_limit);
     void flush();
 
 private:
     template <typename... args_t>
     LogStream stream(level lv, args_t&&... args)
     {
-        bool std_out = static_cast<int>(lv) <= stdout_level_;
-        return LogStream(trace_mutex_, ofs_, lv, std_out, dumps_dir_, std::forward<args_t>(args)...);
+        int lv_int = static_cast<int>(lv);
+        bool std_out = lv_int <= stdout_level_;
+        bool to_file = lv_int <= file_level_;
+        return LogStream(sink_, lv, std_out, to_file, dumps_dir_, std::forward<args_t>(args)...);
     }
 
 private:
-    Logger() = default;
+    friend class StringConverter;
+
+    Logger();
 
     void reinit();
     bool rotate();
@@ -88,12 +117,13 @@ private:
     std::filesystem::path dumps_dir_;
 
 #ifdef MAA_DEBUG
-    MaaLoggingLevel stdout_level_ = MaaLoggingLevel_All;
+    std::atomic<MaaLoggingLevel> stdout_level_ = MaaLoggingLevel_All;
 #else
-    MaaLoggingLevel stdout_level_ = MaaLoggingLevel_Error;
+    std::atomic<MaaLoggingLevel> stdout_level_ = MaaLoggingLevel_Error;
 #endif
-    std::ofstream ofs_;
-    std::mutex trace_mutex_;
+    std::atomic<MaaLoggingLevel> file_level_ = MaaLoggingLevel_All;
+    LogSink sink_;
+    std::unique_ptr<ImageDumper> image_dumper_;
 };
 
 class LogScopeEnterHelper
@@ -124,6 +154,10 @@ public:
 
     ~LogScopeLeaveHelper()
     {
+        if (!Logger::get_instance().enabled(level::trace)) {
+            return;
+        }
+
         std::apply([](auto&&... args) { return Logger::get_instance().trace(std::forward<decltype(args)>(args)...); }, std::move(args_))
             << "| leave," << duration_since(start_);
     }
@@ -154,16 +188,42 @@ MAA_LOG_NS_END
 #endif
 #define LOG_ARGS MAA_FILE, MAA_LINE, MAA_FUNCTION
 
-#define LogFatal MAA_LOG_NS::Logger::get_instance().fatal(LOG_ARGS)
-#define LogError MAA_LOG_NS::Logger::get_instance().error(LOG_ARGS)
-#define LogWarn MAA_LOG_NS::Logger::get_instance().warn(LOG_ARGS)
-#define LogInfo MAA_LOG_NS::Logger::get_instance().info(LOG_ARGS)
-#define LogDebug MAA_LOG_NS::Logger::get_instance().debug(LOG_ARGS)
-#define LogTrace MAA_LOG_NS::Logger::get_instance().trace(LOG_ARGS)
+// a disabled level costs a branch, the streamed values are not even evaluated
+#define MAA_LOG_IF_ENABLED(lv)                                                  \
+    if (!MAA_LOG_NS::Logger::get_instance().enabled(MAA_LOG_NS::level::lv)) { \
+    }                                                                           \
+    else                                                                        \
+        MAA_LOG_NS::Logger::get_instance().lv(LOG_ARGS)
+
+#define LogFatal MAA_LOG_IF_ENABLED(fatal)
+#define LogError MAA_LOG_IF_ENABLED(error)
+#define LogWarn MAA_LOG_IF_ENABLED(warn)
+#define LogInfo MAA_LOG_IF_ENABLED(info)
+#define LogDebug MAA_LOG_IF_ENABLED(debug)
+
+// the scope entry is logged at debug, gated the same way, so the values streamed into LogFunc are not evaluated either
+#define MAA_LOG_SCOPE_ENTER                                                        \
+    if (!MAA_LOG_NS::Logger::get_instance().enabled(MAA_LOG_NS::level::debug)) { \
+    }                                                                              \
+    else                                                                           \
+        MAA_LOG_NS::LogScopeEnterHelper(LOG_ARGS)()
+
+#if MAA_LOG_TRACE
+#define LogTrace MAA_LOG_IF_ENABLED(trace)
 
 #define LogFunc                                                   \
     MAA_LOG_NS::LogScopeLeaveHelper ScopeHelperVarName(LOG_ARGS); \
-    MAA_LOG_NS::LogScopeEnterHelper(LOG_ARGS)()
+    MAA_LOG_SCOPE_ENTER
+#else
+// still compiled, so that it does not rot, but never generated
+#define LogTrace           \
+    if constexpr (true) { \
+    }                      \
+    else                   \
+        MAA_LOG_NS::Logger::get_instance().trace(LOG_ARGS)
+
+#define LogFunc MAA_LOG_SCOPE_ENTER
+#endif
 
 #define VAR_RAW(x) "[" << #x << "=" << (x) << "] "
 #define VAR(x) MAA_LOG_NS::separator::none << VAR_RAW(x) << MAA_LOG_NS::separator::space
@@ -4,11 +4,14 @@
 #include <unistd.h>
 #endif
 
+#include <atomic>
+#include <condition_variable>
 #include <filesystem>
 #include <format>
 #include <fstream>
 #include <iostream>
 #include <mutex>
+#include <optional>
 #include <sstream>
 #include <thread>
 #include <type_traits>
@@ -119,17 +122,99 @@ private:
 template <typename T>
 concept string_convertible = requires { std::declval<StringConverter>()(std::declval<T>()); };
 
+// Writes the log on a background thread, so that logging threads neither wait for each other nor for the disk.
+// Records are pushed onto a lock-free queue and written in batches. The file is flushed once kFlushBytes are pending,
+// every kFlushInterval, right after an error and on flush().
+class MAA_UTILS_API LogSink
+{
+public:
+    struct Record
+    {
+        level lv = level::fatal;
+        bool to_stdout = false;
+        bool to_file = false;
+        std::string text;
+    };
+
+    inline static constexpr size_t kFlushBytes = 64 * 1024;
+    inline static constexpr std::chrono::milliseconds kFlushInterval { 500 };
+
+public:
+    LogSink();
+    ~LogSink();
+
+    LogSink(const LogSink&) = delete;
+    LogSink(LogSink&&) = delete;
+    LogSink& operator=(const LogSink&) = delete;
+    LogSink& operator=(LogSink&&) = delete;
+
+public:
+    void push(Record record);
+    // blocks until everything pushed before is written and flushed
+    void flush();
+
+    // records pushed before are written to the previous file
+    void open(const std::filesystem::path& path);
+    void close();
+
+private:
+    struct Node
+    {
+        std::atomic<Node*> next = nullptr;
+        Record record;
+    };
+
+    void working();
+    // false once the writer has stopped or was terminated
+    bool writer_running();
+    // writes what is left on the calling thread, only when the writer is not running
+    void drain();
+    // only called by the writer, or by drain()
+    bool pop(Record& record);
+    bool has_pending() const { return tail_->next.load() != nullptr; }
+
+    static std::string stdout_string(const Record& record);
+
+private:
+    // MPSC queue: producers swap their node in at head_, the writer follows `next` from tail_, whose record is already taken
+    std::atomic<Node*> head_ = nullptr;
+    Node* tail_ = nullptr;
+    std::atomic_uint64_t pushed_ = 0;
+
+    std::mutex wake_mutex_;
+    std::condition_variable wake_cond_;
+    std::atomic_bool sleeping_ = false;
+    std::atomic_bool exit_ = false;
+
+    std::mutex flush_mutex_;
+    std::condition_variable flush_cond_;
+    uint64_t flush_target_ = 0;
+    uint64_t flushed_ = 0;
+    std::atomic_bool stopped_ = false;
+
+    std::mutex file_mutex_;
+    std::ofstream ofs_;
+
+    std::thread thread_;
+};
+
 class MAA_UTILS_API LogStream
 {
 public:
+    // when neither stdout nor the file wants it, nothing is formatted and the values streamed in are never converted
     template <typename... args_t>
-    LogStream(std::mutex& m, std::ofstream& s, level lv, bool std_out, std::filesystem::path dumps_dir, args_t&&... args)
-        : mutex_(m)
-        , stream_(s)
+    LogStream(LogSink& sink, level lv, bool std_out, bool to_file, std::filesystem::path dumps_dir, args_t&&... args)
+        : sink_(sink)
         , lv_(lv)
         , stdout_(std_out)
-        , string_converter_(std::move(dumps_dir))
+        , to_file_(to_file)
     {
+        if (!stdout_ && !to_file_) {
+            return;
+        }
+
+        string_converter_.emplace(std::move(dumps_dir));
+        buffer_.emplace();
         stream_props(std::forward<args_t>(args)...);
     }
 
@@ -138,12 +223,16 @@ public:
 
     ~LogStream()
     {
-        std::unique_lock lock(mutex_);
+        if (!buffer_) {
+            return;
+        }
 
-        if (stdout_) {
-            std::cout << stdout_string() << std::endl;
+        sink_.push(LogSink::Record { .lv = lv_, .to_stdout = stdout_, .to_file = to_file_, .text = std::move(*buffer_).str() });
+
+        // the process may not survive what comes next
+        if (lv_ == level::fatal) {
+            sink_.flush();
         }
-        stream_ << std::move(buffer_).str() << std::endl;
     }
 
     template <typename T>
@@ -169,11 +258,15 @@ private:
     template <typename T>
     void stream(T&& value, const separator& sep)
     {
+        if (!buffer_) {
+            return;
+        }
+
         if constexpr (string_convertible<T>) {
-            buffer_ << string_converter_(std::forward<T>(value)) << sep.str;
+            *buffer_ << (*string_converter_)(std::forward<T>(value)) << sep.str;
         }
         else {
-            buffer_ << json::serialize(std::forward<T>(value), string_converter_).dumps() << sep.str;
+            *buffer_ << json::serialize(std::forward<T>(value), *string_converter_).dumps() << sep.str;
         }
     }
 
@@ -194,18 +287,17 @@ private:
         stream(props, sep_);
     }
 
-    std::string stdout_string();
     std::string_view level_str();
 
 private:
-    std::mutex& mutex_;
-    std::ofstream& stream_;
+    LogSink& sink_;
     const level lv_ = level::fatal;
     const bool stdout_ = false;
-    const StringConverter string_converter_;
+    const bool to_file_ = false;
+    std::optional<StringConverter> string_converter_;
 
     separator sep_ = separator::space;
-    std::stringstream buffer_;
+    std::optional<std::stringstream> buffer_;
 };
 
 MAA_LOG_NS_END
@@ -0,0 +1,19 @@
+#include <iostream>
+
+#include "module/LatestFrameTesting.h"
+#include "module/RawStreamDecoderTesting.h"
+
+int main()
+{
+    if (!latest_frame_testing()) {
+        std::cerr << "latest_frame_testing failed" << std::endl;
+        return -1;
+    }
+
+    if (!raw_stream_decoder_testing()) {
+        std::cerr << "raw_stream_decoder_testing failed" << std::endl;
+        return -1;
+    }
+
+    return 0;
+}
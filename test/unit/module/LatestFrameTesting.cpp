@@ -0,0 +1,113 @@
+#include "LatestFrameTesting.h"
+
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "Screencap/Minicap/LatestFrame.h"
+
+using MAA_CTRL_UNIT_NS::LatestFrame;
+
+static cv::Mat make_image(uint64_t seq)
+{
+    return cv::Mat(1, 1, CV_64FC1, cv::Scalar(static_cast<double>(seq)));
+}
+
+static bool concurrent_testing()
+{
+    constexpr uint64_t kFrames = 200000;
+    constexpr size_t kProducers = 2;
+    constexpr size_t kConsumers = 4;
+
+    LatestFrame latest;
+    std::atomic_uint64_t next_seq = 0;
+    std::atomic_bool done = false;
+    std::atomic_size_t errors = 0;
+
+    std::vector<std::thread> producers;
+    for (size_t i = 0; i < kProducers; ++i) {
+        producers.emplace_back([&]() {
+            while (true) {
+                uint64_t seq = ++next_seq;
+                if (seq > kFrames) {
+                    return;
+                }
+                latest.publish(make_image(seq), seq, std::chrono::steady_clock::now());
+            }
+        });
+    }
+
+    std::vector<std::thread> consumers;
+    for (size_t i = 0; i < kConsumers; ++i) {
+        consumers.emplace_back([&]() {
+            uint64_t last_seq = 0;
+            while (!done) {
+                auto frame = latest.load();
+                if (!frame) {
+                    continue;
+                }
+                // a torn copy would pair a seq with the image of another frame
+                if (frame->image.empty() || frame->image.at<double>(0, 0) != static_cast<double>(frame->seq)) {
+                    ++errors;
+                }
+                if (frame->seq < last_seq) {
+                    ++errors;
+                }
+                last_seq = frame->seq;
+            }
+        });
+    }
+
+    for (auto& thread : producers) {
+        thread.join();
+    }
+    done = true;
+    for (auto& thread : consumers) {
+        thread.join();
+    }
+
+    auto frame = latest.load();
+    if (!frame || frame->seq != kFrames) {
+        std::cerr << "the last frame is not the newest one" << std::endl;
+        return false;
+    }
+    if (errors != 0) {
+        std::cerr << "inconsistent frames: " << errors << std::endl;
+        return false;
+    }
+    return true;
+}
+
+static bool reset_testing()
+{
+    LatestFrame latest;
+    auto now = std::chrono::steady_clock::now();
+
+    latest.publish(make_image(5), 5, now);
+    latest.publish(make_image(3), 3, now);
+    if (latest.load()->seq != 5) {
+        std::cerr << "an older frame replaced a newer one" << std::endl;
+        return false;
+    }
+
+    latest.reset();
+    if (latest.load()) {
+        std::cerr << "a frame is left after reset" << std::endl;
+        return false;
+    }
+
+    // a new stream starts over from 1
+    latest.publish(make_image(1), 1, now);
+    auto frame = latest.load();
+    if (!frame || frame->seq != 1 || frame->image.at<double>(0, 0) != 1.0) {
+        std::cerr << "the first frame after reset is dropped" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool latest_frame_testing()
+{
+    return reset_testing() && concurrent_testing();
+}
@@ -0,0 +1,3 @@
+#pragma once
+
+bool latest_frame_testing();
@@ -0,0 +1,143 @@
+#include "RawStreamDecoderTesting.h"
+
+#include <cstring>
+#include <iostream>
+#include <string>
+
+#include <zlib.h>
+
+#include "Screencap/RawStreamDecoder.h"
+#include "Utils/NoWarningCV.hpp"
+
+using MAA_CTRL_UNIT_NS::RawStreamDecoder;
+
+static constexpr int kWidth = 5;
+static constexpr int kHeight = 3;
+
+static void append_u32(std::string& str, uint32_t value)
+{
+    char bytes[4] {};
+    std::memcpy(bytes, &value, sizeof(value));
+    str.append(bytes, sizeof(bytes));
+}
+
+static uint8_t channel(int row, int col, int c)
+{
+    // `\r` and `\n` are among the values, so that cleaning CRLF is tested on the pixels too
+    return static_cast<uint8_t>((row * kWidth + col) * 3 + c + 8);
+}
+
+// the output of `screencap`, with a 12 bytes header (width, height, format) or a 16 bytes one (and color space)
+static std::string make_raw(size_t header_size)
+{
+    std::string raw;
+    append_u32(raw, kWidth);
+    append_u32(raw, kHeight);
+    append_u32(raw, 1); // RGBA_8888
+    if (header_size == 16) {
+        append_u32(raw, 1); // sRGB
+    }
+
+    for (int row = 0; row < kHeight; ++row) {
+        for (int col = 0; col < kWidth; ++col) {
+            for (int c = 0; c < 3; ++c) {
+                raw.push_back(static_cast<char>(channel(row, col, c)));
+            }
+            raw.push_back(static_cast<char>(0xFF));
+        }
+    }
+    return raw;
+}
+
+// what a pipe that turns `\n` into `\r\n` delivers
+static std::string to_crlf(const std::string& data)
+{
+    std::string result;
+    for (char ch : data) {
+        if (ch == '\n') {
+            result.push_back('\r');
+        }
+        result.push_back(ch);
+    }
+    return result;
+}
+
+static std::string to_gzip(const std::string& data)
+{
+    z_stream zs {};
+    // 16: write a gzip header instead of a zlib one
+    deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+
+    std::string result(deflateBound(&zs, static_cast<uLong>(data.size())), '\0');
+    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    zs.avail_in = static_cast<uInt>(data.size());
+    zs.next_out = reinterpret_cast<Bytef*>(result.data());
+    zs.avail_out = static_cast<uInt>(result.size());
+    deflate(&zs, Z_FINISH);
+    result.resize(zs.total_out);
+    deflateEnd(&zs);
+
+    return result;
+}
+
+static bool check_image(const cv::Mat& image)
+{
+    if (image.cols != kWidth || image.rows != kHeight || image.type() != CV_8UC3) {
+        return false;
+    }
+    for (int row = 0; row < kHeight; ++row) {
+        for (int col = 0; col < kWidth; ++col) {
+            const auto& bgr = image.at<cv::Vec3b>(row, col);
+            if (bgr[0] != channel(row, col, 2) || bgr[1] != channel(row, col, 1) || bgr[2] != channel(row, col, 0)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static bool decode_testing(const std::string& name, const std::string& data, bool gzip, bool clean_cr)
+{
+    // 1 splits every `\r\n`, the others split the header and the rows at various places
+    for (size_t chunk_size : { size_t(1), size_t(7), size_t(13), data.size() }) {
+        RawStreamDecoder decoder(gzip, clean_cr);
+
+        bool ret = true;
+        for (size_t pos = 0; pos < data.size() && ret; pos += chunk_size) {
+            ret = decoder.feed(std::string_view(data).substr(pos, chunk_size));
+        }
+
+        auto image_opt = ret ? decoder.finish() : std::nullopt;
+        if (!image_opt || !check_image(*image_opt)) {
+            std::cerr << name << " failed" << " chunk_size: " << chunk_size << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool broken_testing()
+{
+    std::string raw = make_raw(16);
+    raw.resize(raw.size() - 1);
+
+    RawStreamDecoder decoder(false, false);
+    decoder.feed(raw);
+    if (decoder.finish()) {
+        std::cerr << "a truncated image is decoded" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool raw_stream_decoder_testing()
+{
+    const std::string raw12 = make_raw(12);
+    const std::string raw16 = make_raw(16);
+
+    return decode_testing("12 bytes header", raw12, false, false) && decode_testing("16 bytes header", raw16, false, false)
+           && decode_testing("12 bytes header, CRLF", to_crlf(raw12), false, true)
+           && decode_testing("16 bytes header, CRLF", to_crlf(raw16), false, true)
+           && decode_testing("12 bytes header, gzip", to_gzip(raw12), true, false)
+           && decode_testing("16 bytes header, gzip, CRLF", to_crlf(to_gzip(raw16)), true, true) && broken_testing();
+}
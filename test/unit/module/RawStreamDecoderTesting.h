@@ -0,0 +1,3 @@
+#pragma once
+
+bool raw_stream_decoder_testing();